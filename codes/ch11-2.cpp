@@ -0,0 +1,435 @@
+#include <iostream>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+// Sorted vector of key/value pairs. Lookups are a binary search over contiguous
+// memory and iteration is a linear scan; single inserts and erases shift the tail,
+// so build it in bulk (the range constructor) and use eraseIf for batches.
+template<typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+public:
+    using value_type = std::pair<K, V>;
+    using iterator = typename vector<value_type>::iterator;
+    using const_iterator = typename vector<value_type>::const_iterator;
+
+    FlatMap() = default;
+    // sort + unique, the first occurrence of a key wins (same as inserting one by one)
+    explicit FlatMap(vector<value_type> items) : items(std::move(items)) {
+        std::stable_sort(this->items.begin(), this->items.end(), [this](const auto& a, const auto& b) { return comp(a.first, b.first); });
+        auto last = std::unique(this->items.begin(), this->items.end(), [this](const auto& a, const auto& b) {
+            return !comp(a.first, b.first) && !comp(b.first, a.first);
+        });
+        this->items.erase(last, this->items.end());
+    }
+
+    iterator find(const K& key) {
+        auto it = lowerBound(key);
+        return it != items.end() && !comp(key, it->first) ? it : items.end();
+    }
+    const_iterator find(const K& key) const { return const_cast<FlatMap*>(this)->find(key); }
+    bool contains(const K& key) const { return find(key) != items.end(); }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        auto it = lowerBound(key);
+        if (it != items.end() && !comp(key, it->first)) return {it, false};
+        it = items.emplace(it, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        return {it, true};
+    }
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    size_t erase(const K& key) {
+        auto it = find(key);
+        if (it == items.end()) return 0;
+        items.erase(it);
+        return 1;
+    }
+    // one pass, stays sorted
+    template<typename Pred>
+    size_t eraseIf(Pred pred) {
+        auto last = std::remove_if(items.begin(), items.end(), [&](const value_type& kv) { return pred(kv); });
+        size_t n = items.end() - last;
+        items.erase(last, items.end());
+        return n;
+    }
+
+    void reserve(size_t n) { items.reserve(n); }
+    void clear() { items.clear(); }
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    iterator begin() { return items.begin(); }
+    iterator end() { return items.end(); }
+    const_iterator begin() const { return items.begin(); }
+    const_iterator end() const { return items.end(); }
+private:
+    iterator lowerBound(const K& key) {
+        return std::lower_bound(items.begin(), items.end(), key, [this](const value_type& kv, const K& k) { return comp(kv.first, k); });
+    }
+
+    vector<value_type> items;
+    [[no_unique_address]] Compare comp;
+};
+
+// Open-addressing hash map in the Swiss table layout: one control byte per slot,
+// holding 7 bits of the hash for a full slot or a marker for empty/deleted. A probe
+// loads a group of 16 control bytes and compares them all at once (SSE2, or a
+// scalar loop elsewhere), so most lookups touch one control line and one slot.
+// Groups are aligned and probed triangularly, which visits every group of a
+// power-of-two table. The key of a slot must not be modified through an iterator.
+template<typename K, typename V, typename Hash = std::hash<K>>
+class SwissMap {
+public:
+    using value_type = std::pair<K, V>;
+    static constexpr size_t groupSize = 16;
+
+    template<bool Const>
+    class Iterator {
+    public:
+        using Map = std::conditional_t<Const, const SwissMap, SwissMap>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        Iterator(Map* map, size_t index) : map(map), index(index) { skipEmpty(); }
+        reference operator*() const { return map->slots[index]; }
+        pointer operator->() const { return &map->slots[index]; }
+        Iterator& operator++() {
+            ++index;
+            skipEmpty();
+            return *this;
+        }
+        bool operator==(const Iterator& o) const { return index == o.index; }
+        bool operator!=(const Iterator& o) const { return index != o.index; }
+        size_t slotIndex() const { return index; }
+    private:
+        void skipEmpty() {
+            while (index < map->capacity && map->ctrl[index] < 0) ++index;
+        }
+        Map* map;
+        size_t index;
+    };
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SwissMap() = default;
+    SwissMap(const SwissMap& o) {
+        reserve(o.count);
+        for (const auto& [k, v] : o) try_emplace(k, v);
+    }
+    SwissMap(SwissMap&& o) noexcept { swap(o); }
+    SwissMap& operator=(SwissMap o) {
+        swap(o);
+        return *this;
+    }
+    ~SwissMap() {
+        clear();
+        std::allocator<value_type>().deallocate(slots, capacity);
+    }
+    void swap(SwissMap& o) noexcept {
+        std::swap(ctrl, o.ctrl);
+        std::swap(slots, o.slots);
+        std::swap(capacity, o.capacity);
+        std::swap(count, o.count);
+        std::swap(growthLeft, o.growthLeft);
+    }
+
+    iterator find(const K& key) { return {this, findIndex(key)}; }
+    const_iterator find(const K& key) const { return {this, findIndex(key)}; }
+    bool contains(const K& key) const { return findIndex(key) != capacity; }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        size_t h = hashOf(key);
+        size_t found = findIndex(key, h);
+        if (found != capacity) return {iterator(this, found), false};
+        if (growthLeft == 0) rehash(std::max(capacity * 2, groupSize));
+        size_t index = findInsertSlot(h);
+        if (ctrl[index] == kEmpty) --growthLeft; // reusing a tombstone does not shrink the free space
+        ctrl[index] = h2(h);
+        std::construct_at(slots + index, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        ++count;
+        return {iterator(this, index), true};
+    }
+    std::pair<iterator, bool> insert(const value_type& kv) { return try_emplace(kv.first, kv.second); }
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    size_t erase(const K& key) {
+        size_t index = findIndex(key);
+        if (index == capacity) return 0;
+        eraseAt(index);
+        return 1;
+    }
+    iterator erase(iterator it) {
+        eraseAt(it.slotIndex());
+        return ++it;
+    }
+    template<typename Pred>
+    size_t eraseIf(Pred pred) {
+        size_t before = count;
+        for (size_t i = 0; i < capacity; ++i) {
+            if (ctrl[i] >= 0 && pred(slots[i])) eraseAt(i);
+        }
+        return before - count;
+    }
+
+    void reserve(size_t n) {
+        size_t needed = groupSize;
+        while (maxLoad(needed) < n) needed *= 2;
+        if (needed > capacity) rehash(needed);
+    }
+    void clear() {
+        for (size_t i = 0; i < capacity; ++i) {
+            if (ctrl[i] >= 0) std::destroy_at(slots + i);
+        }
+        std::fill(ctrl.get(), ctrl.get() + capacity, kEmpty);
+        count = 0;
+        growthLeft = maxLoad(capacity);
+    }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, capacity}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, capacity}; }
+private:
+    static constexpr int8_t kEmpty = -128;  // 0b10000000
+    static constexpr int8_t kDeleted = -2;  // 0b11111110, full slots are 0b0xxxxxxx
+
+    // bit i set when control byte i of the group matches
+    struct Group {
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128i bytes;
+        explicit Group(const int8_t* p) : bytes(_mm_load_si128(reinterpret_cast<const __m128i*>(p))) {}
+        uint32_t match(int8_t h) const { return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h))); }
+        uint32_t matchEmpty() const { return match(kEmpty); }
+        uint32_t matchEmptyOrDeleted() const { return _mm_movemask_epi8(bytes); } // high bit set
+#else
+        const int8_t* p;
+        explicit Group(const int8_t* p) : p(p) {}
+        uint32_t match(int8_t h) const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < groupSize; ++i) mask |= uint32_t(p[i] == h) << i;
+            return mask;
+        }
+        uint32_t matchEmpty() const { return match(kEmpty); }
+        uint32_t matchEmptyOrDeleted() const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < groupSize; ++i) mask |= uint32_t(p[i] < 0) << i;
+            return mask;
+        }
+#endif
+    };
+
+    // std::hash<int> is the identity, mix so both the group index and the 7 tag bits are spread
+    size_t hashOf(const K& key) const {
+        uint64_t h = static_cast<uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+    static int8_t h2(size_t h) { return static_cast<int8_t>(h & 0x7F); }
+    static size_t maxLoad(size_t cap) { return cap - cap / 8; } // 7/8
+    size_t numGroups() const { return capacity / groupSize; }
+
+    size_t findIndex(const K& key) const { return capacity == 0 ? 0 : findIndex(key, hashOf(key)); }
+    size_t findIndex(const K& key, size_t h) const {
+        if (capacity == 0) return 0;
+        size_t mask = numGroups() - 1;
+        size_t g = (h >> 7) & mask;
+        for (size_t step = 1;; ++step) {
+            Group group(ctrl.get() + g * groupSize);
+            for (uint32_t m = group.match(h2(h)); m; m &= m - 1) {
+                size_t index = g * groupSize + std::countr_zero(m);
+                if (slots[index].first == key) return index;
+            }
+            if (group.matchEmpty()) return capacity;
+            g = (g + step) & mask;
+        }
+    }
+    size_t findInsertSlot(size_t h) const {
+        size_t mask = numGroups() - 1;
+        size_t g = (h >> 7) & mask;
+        for (size_t step = 1;; ++step) {
+            uint32_t m = Group(ctrl.get() + g * groupSize).matchEmptyOrDeleted();
+            if (m) return g * groupSize + std::countr_zero(m);
+            g = (g + step) & mask;
+        }
+    }
+    // A group that still has an empty slot has never been probed past, so the
+    // slot can go straight back to empty; otherwise it needs a tombstone.
+    void eraseAt(size_t index) {
+        std::destroy_at(slots + index);
+        --count;
+        if (Group(ctrl.get() + index / groupSize * groupSize).matchEmpty()) {
+            ctrl[index] = kEmpty;
+            ++growthLeft;
+        } else {
+            ctrl[index] = kDeleted;
+        }
+    }
+
+    void rehash(size_t newCapacity) {
+        // mostly tombstones: rebuild at the same size instead of doubling
+        if (newCapacity == capacity * 2 && count < maxLoad(capacity) / 2) newCapacity = capacity;
+        auto oldCtrl = std::move(ctrl);
+        value_type* oldSlots = slots;
+        size_t oldCapacity = capacity;
+
+        ctrl.reset(new (std::align_val_t(groupSize)) int8_t[newCapacity]);
+        std::fill(ctrl.get(), ctrl.get() + newCapacity, kEmpty);
+        slots = std::allocator<value_type>().allocate(newCapacity);
+        capacity = newCapacity;
+        growthLeft = maxLoad(newCapacity) - count;
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] < 0) continue;
+            size_t h = hashOf(oldSlots[i].first);
+            size_t index = findInsertSlot(h);
+            ctrl[index] = h2(h);
+            std::construct_at(slots + index, std::move(oldSlots[i]));
+            std::destroy_at(oldSlots + i);
+        }
+        std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+    }
+
+    struct AlignedDelete {
+        void operator()(int8_t* p) const { ::operator delete[](p, std::align_val_t(groupSize)); }
+    };
+    std::unique_ptr<int8_t[], AlignedDelete> ctrl;
+    value_type* slots = nullptr;
+    size_t capacity = 0;
+    size_t count = 0;
+    size_t growthLeft = 0;
+    [[no_unique_address]] Hash hasher;
+};
+
+long long sink = 0; // keeps the measured loops from being optimized away
+
+template<typename Body>
+double nsPerOp(size_t nOps, Body body) {
+    auto start = std::chrono::high_resolution_clock::now();
+    body();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / std::max<size_t>(nOps, 1);
+}
+
+struct Row {
+    const char* op;
+    double ns[4] = {};
+};
+
+// insert, lookup hit/miss, iteration and erase for one container type. FlatMap is
+// built in bulk (sort + unique) and erased with one eraseIf pass, its intended use.
+template<typename Map>
+void measure(const vector<int>& keys, const vector<int>& hits, const vector<int>& misses, vector<Row>& rows, int column) {
+    Map m;
+    rows[0].ns[column] = nsPerOp(keys.size(), [&] {
+        if constexpr (std::is_same_v<Map, FlatMap<int, int>>) {
+            vector<std::pair<int, int>> items;
+            items.reserve(keys.size());
+            for (int k : keys) items.push_back({k, k});
+            m = Map(std::move(items));
+        } else {
+            for (int k : keys) m[k] = k;
+        }
+    });
+    rows[1].ns[column] = nsPerOp(hits.size(), [&] {
+        for (int k : hits) sink += m.find(k)->second;
+    });
+    rows[2].ns[column] = nsPerOp(misses.size(), [&] {
+        for (int k : misses) sink += m.find(k) == m.end();
+    });
+    rows[3].ns[column] = nsPerOp(m.size(), [&] {
+        for (const auto& [k, v] : m) sink += v;
+    });
+    // drop the odd half
+    rows[4].ns[column] = nsPerOp(keys.size() / 2, [&] {
+        if constexpr (std::is_same_v<Map, std::map<int, int>> || std::is_same_v<Map, std::unordered_map<int, int>>) {
+            sink += std::erase_if(m, [](const auto& kv) { return kv.first & 1; });
+        } else {
+            sink += m.eraseIf([](const auto& kv) { return kv.first & 1; });
+        }
+    });
+    sink += m.size();
+}
+
+int main(int argc, char* argv[]) {
+    cout << "\n\nProblem 1: FlatMap and SwissMap basics" << endl;
+    // the ch4-2.cpp hot map, unordered_map<int, int>, on both containers
+    FlatMap<int, int> flat;
+    SwissMap<int, int> swiss;
+    for (int i = 0; i < 10; ++i) {
+        int value = rand() % 100;
+        flat[i] = value;
+        swiss[i] = value;
+    }
+    for (const auto& [idx, value] : flat) {
+        cout << "Index: " << idx << ", Value: " << value << ", SwissMap agrees: " << boolalpha << (swiss.find(idx)->second == value) << endl;
+    }
+    swiss.erase(3);
+    flat.erase(3);
+    cout << "After erasing 3: SwissMap size " << swiss.size() << ", FlatMap size " << flat.size()
+         << ", contains(3) " << swiss.contains(3) << "/" << flat.contains(3) << endl;
+
+    // consistency check against std::unordered_map under a random insert/erase mix
+    SwissMap<int, int> check;
+    unordered_map<int, int> reference;
+    std::mt19937 rng(11);
+    for (int i = 0; i < 1'000'000; ++i) {
+        int k = rng() % 50'000;
+        if (rng() % 3 == 0) {
+            if (check.erase(k) != reference.erase(k)) cout << "erase mismatch at " << k << endl;
+        } else {
+            check[k] = i;
+            reference[k] = i;
+        }
+    }
+    bool same = check.size() == reference.size();
+    for (const auto& [k, v] : reference) same = same && check.contains(k) && check.find(k)->second == v;
+    cout << "SwissMap matches unordered_map after 1M random ops: " << same << endl;
+
+    // usage: ch11-2 [max entries], e.g. 100000000 (std::map needs ~5 GB at that size)
+    size_t maxEntries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    cout << "\n\nProblem 2: std::map vs unordered_map vs FlatMap vs SwissMap, int -> int (ns per op)" << endl;
+    for (size_t n = 1'000; n <= maxEntries; n *= 10) {
+        // i * odd constant is a bijection on 32 bits: distinct pseudo-random keys, misses from [n, 2n)
+        auto keyOf = [](size_t i) { return static_cast<int>(static_cast<uint32_t>(i) * 2654435761u); };
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) keys[i] = keyOf(i);
+        size_t nLookups = std::min<size_t>(n, 1'000'000);
+        vector<int> hits(nLookups);
+        vector<int> misses(nLookups);
+        std::mt19937 rng(static_cast<unsigned>(n));
+        for (size_t i = 0; i < nLookups; ++i) {
+            hits[i] = keyOf(rng() % n);
+            misses[i] = keyOf(n + rng() % n);
+        }
+
+        vector<Row> rows = {{"insert"}, {"lookup hit"}, {"lookup miss"}, {"iterate"}, {"erase half"}};
+        measure<std::map<int, int>>(keys, hits, misses, rows, 0);
+        measure<std::unordered_map<int, int>>(keys, hits, misses, rows, 1);
+        measure<FlatMap<int, int>>(keys, hits, misses, rows, 2);
+        measure<SwissMap<int, int>>(keys, hits, misses, rows, 3);
+
+        cout << n << " entries" << endl;
+        cout << setw(14) << "" << setw(12) << "map" << setw(16) << "unordered_map" << setw(12) << "FlatMap" << setw(12) << "SwissMap" << endl;
+        for (const auto& row : rows) {
+            cout << setw(14) << row.op << fixed << setprecision(1) << setw(12) << row.ns[0] << setw(16) << row.ns[1]
+                 << setw(12) << row.ns[2] << setw(12) << row.ns[3] << endl;
+        }
+    }
+    cout << "(checksum " << sink << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,402 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <functional>
+#include <span>
+#include <new>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <stdexcept>
+using namespace std;
+
+template<typename Signature>
+class FunctionRef;
+
+// Non-owning view of a callable: one pointer to the object, one to a thunk.
+// The callable must outlive the FunctionRef, like string_view and its string.
+template<typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+public:
+    template<typename F>
+        requires (!std::is_same_v<std::remove_cvref_t<F>, FunctionRef> && std::is_invocable_r_v<R, F&, Args...>)
+    FunctionRef(F&& f) noexcept
+        : obj(const_cast<void*>(static_cast<const void*>(std::addressof(f)))),
+          thunk([](void* o, Args... args) -> R {
+              return std::invoke(*static_cast<std::remove_reference_t<F>*>(o), std::forward<Args>(args)...);
+          }) {}
+
+    R operator()(Args... args) const { return thunk(obj, std::forward<Args>(args)...); }
+private:
+    void* obj;
+    R (*thunk)(void*, Args...);
+};
+
+template<typename Signature, size_t Capacity = 32>
+class InplaceFunction;
+
+// Owning callable stored in a fixed inline buffer, never touches the heap.
+// A callable larger than Capacity is a compile error instead of an allocation.
+// Move-only, so it can hold move-only callables (unique_ptr captures).
+template<typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    InplaceFunction() = default;
+
+    template<typename F>
+        requires (!std::is_same_v<std::remove_cvref_t<F>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    InplaceFunction(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "callable does not fit in InplaceFunction, raise Capacity");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "over-aligned callable");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "callable must be nothrow movable");
+        ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+        invoker = [](void* s, Args... args) -> R {
+            return std::invoke(*std::launder(static_cast<Fn*>(s)), std::forward<Args>(args)...);
+        };
+        manager = [](Op op, void* dst, void* src) {
+            switch (op) {
+            case Op::Move:
+                ::new (dst) Fn(std::move(*std::launder(static_cast<Fn*>(src))));
+                std::launder(static_cast<Fn*>(src))->~Fn();
+                break;
+            case Op::Destroy:
+                std::launder(static_cast<Fn*>(dst))->~Fn();
+                break;
+            }
+        };
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction(InplaceFunction&& other) noexcept : invoker(other.invoker), manager(other.manager) {
+        if (manager) manager(Op::Move, storage, other.storage);
+        other.invoker = &emptyInvoker;
+        other.manager = nullptr;
+    }
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this == &other) return *this;
+        reset();
+        invoker = other.invoker;
+        manager = other.manager;
+        if (manager) manager(Op::Move, storage, other.storage);
+        other.invoker = &emptyInvoker;
+        other.manager = nullptr;
+        return *this;
+    }
+    ~InplaceFunction() { reset(); }
+
+    void reset() {
+        if (manager) manager(Op::Destroy, storage, nullptr);
+        invoker = &emptyInvoker;
+        manager = nullptr;
+    }
+    explicit operator bool() const { return manager != nullptr; }
+    // throws bad_function_call when empty, like std::function; the empty state has
+    // its own invoker, so a call carries no null check
+    R operator()(Args... args) const {
+        return invoker(const_cast<std::byte*>(storage), std::forward<Args>(args)...);
+    }
+private:
+    enum class Op { Move, Destroy };
+    alignas(std::max_align_t) std::byte storage[Capacity];
+    static R emptyInvoker(void*, Args...) { throw std::bad_function_call(); }
+    R (*invoker)(void*, Args...) = &emptyInvoker;
+    void (*manager)(Op, void*, void*) = nullptr;
+};
+
+// Observer from the handout, reworked: subscribers sit in one contiguous vector,
+// callbacks are moved in (never copied) and each one receives a whole batch.
+// Callbacks may subscribe and unsubscribe (themselves included) while notify()
+// runs: new subscribers are parked until the outermost notify() returns and
+// removed ones are only flagged, so the vector is never modified mid-loop.
+// A notify() with nothing parked or flagged does no cleanup at all, and the
+// cleanup also runs when a callback throws.
+template<typename T, size_t Capacity = 32>
+class Event {
+public:
+    using Token = uint64_t;
+    using Callback = InplaceFunction<void(std::span<const T>), Capacity>;
+
+    // callback taking the whole batch
+    template<typename F>
+        requires std::is_invocable_v<F&, std::span<const T>>
+    Token subscribe(F&& cb) {
+        if (notifying) {
+            pending.push_back({nextToken, true, Callback(std::forward<F>(cb))});
+            ++deferred;
+        } else {
+            subscribers.push_back({nextToken, true, Callback(std::forward<F>(cb))});
+        }
+        return nextToken++;
+    }
+    // callback taking one value, called once per element of the batch
+    template<typename F>
+        requires (!std::is_invocable_v<F&, std::span<const T>> && std::is_invocable_v<F&, const T&>)
+    Token subscribe(F&& cb) {
+        return subscribe([cb = std::forward<F>(cb)](std::span<const T> values) mutable {
+            for (const auto& v : values) cb(v);
+        });
+    }
+    bool unsubscribe(Token token) {
+        auto match = [token](const Subscriber& s) { return s.token == token; };
+        if (std::erase_if(pending, match) > 0) {
+            --deferred;
+            return true;
+        }
+        if (notifying == 0) return std::erase_if(subscribers, match) > 0;
+        for (auto& s : subscribers) {
+            if (s.active && s.token == token) {
+                s.active = false; // erased once the outermost notify() is done
+                ++removed;
+                ++deferred;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void notify(const T& value) { notify(std::span<const T>(&value, 1)); }
+    void notify(std::span<const T> values) {
+        NotifyScope scope(*this);
+        for (auto& s : subscribers) {
+            if (s.active) s.callback(values);
+        }
+    }
+    size_t size() const { return subscribers.size() - removed + pending.size(); }
+private:
+    // depth counter as a scope guard, so a throwing callback cannot leave the Event
+    // stuck in "notifying" mode
+    struct NotifyScope {
+        Event& event;
+        explicit NotifyScope(Event& e) : event(e) { ++event.notifying; }
+        ~NotifyScope() {
+            if (--event.notifying == 0 && event.deferred != 0) event.applyDeferred();
+        }
+    };
+    void applyDeferred() {
+        if (removed != 0) {
+            std::erase_if(subscribers, [](const Subscriber& s) { return !s.active; });
+            removed = 0;
+        }
+        for (auto& s : pending) subscribers.push_back(std::move(s));
+        pending.clear();
+        deferred = 0;
+    }
+
+    struct Subscriber {
+        Token token;
+        bool active; // fits in the padding before the aligned callback, keeps entries at 64 bytes
+        Callback callback;
+    };
+    vector<Subscriber> subscribers;
+    vector<Subscriber> pending; // subscribed during notify()
+    int notifying = 0;          // notify() depth, callbacks may notify again
+    size_t removed = 0;         // flagged inactive during notify(), not yet erased
+    size_t deferred = 0;        // removed + pending.size(), one test on the hot path
+    Token nextToken = 0;
+};
+
+// the handout's std::function version, kept for comparison
+class FunctionEvent {
+    std::vector<std::function<void(int)>> subscribers;
+public:
+    void subscribe(std::function<void(int)> cb) {
+        subscribers.push_back(cb);
+    }
+    void notify(int value) {
+        for (auto& cb : subscribers) cb(value);
+    }
+};
+
+// FNV-1a plus an avalanche step, as in ch9-3.cpp's CommandDispatcher
+constexpr uint64_t fnv1a(std::string_view s, uint64_t seed = 0) {
+    uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Name -> value table for registries that are filled once at startup: add() stages
+// entries, freeze() builds a minimal perfect hash (hash and displace), and find()
+// is one hash, one displacement load and one string compare. Same scheme as the
+// ch9-3.cpp CommandDispatcher, for any value type.
+template<typename V>
+class FrozenRegistry {
+public:
+    void add(std::string name, V value) {
+        if (frozen) throw std::logic_error("registry is frozen");
+        staging.push_back({std::move(name), std::move(value)});
+    }
+
+    void freeze() {
+        if (frozen) throw std::logic_error("registry is frozen");
+        const size_t n = staging.size();
+        vector<std::string_view> sorted;
+        for (const auto& e : staging) sorted.push_back(e.name);
+        std::sort(sorted.begin(), sorted.end());
+        auto dup = std::adjacent_find(sorted.begin(), sorted.end());
+        if (dup != sorted.end()) throw std::invalid_argument("duplicate name " + std::string(*dup));
+
+        nBuckets = std::max<size_t>(1, n / 2 + 1);
+        displacement.assign(nBuckets, 0);
+        vector<vector<size_t>> buckets(nBuckets);
+        for (size_t i = 0; i < n; ++i) buckets[fnv1a(staging[i].name) % nBuckets].push_back(i);
+        vector<size_t> order(nBuckets);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        vector<size_t> slotOf(n);
+        vector<bool> used(n, false);
+        for (size_t b : order) {
+            if (buckets[b].empty()) break;
+            for (uint32_t seed = 1;; ++seed) {
+                vector<size_t> slots;
+                bool ok = true;
+                for (size_t i : buckets[b]) {
+                    size_t slot = fnv1a(staging[i].name, seed) % n;
+                    if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) { ok = false; break; }
+                    slots.push_back(slot);
+                }
+                if (!ok) continue;
+                for (size_t k = 0; k < slots.size(); ++k) {
+                    used[slots[k]] = true;
+                    slotOf[buckets[b][k]] = slots[k];
+                }
+                displacement[b] = seed;
+                break;
+            }
+        }
+        // values may be move-only, so move each staged entry once, in slot order
+        vector<size_t> bySlot(n);
+        for (size_t i = 0; i < n; ++i) bySlot[slotOf[i]] = i;
+        for (size_t slot = 0; slot < n; ++slot) entries.push_back(std::move(staging[bySlot[slot]]));
+        staging.clear();
+        frozen = true;
+    }
+
+    // nullptr for an unknown name
+    const V* find(std::string_view name) const {
+        if (entries.empty()) return nullptr;
+        uint32_t seed = displacement[fnv1a(name) % nBuckets];
+        const Entry& e = entries[fnv1a(name, seed) % entries.size()];
+        return seed != 0 && e.name == name ? &e.value : nullptr;
+    }
+    size_t size() const { return entries.size(); }
+private:
+    struct Entry {
+        std::string name;
+        V value;
+    };
+    vector<Entry> staging;
+    vector<Entry> entries;
+    vector<uint32_t> displacement; // 0 marks an empty bucket
+    size_t nBuckets = 1;
+    bool frozen = false;
+};
+
+class Base { public: virtual void run() = 0; virtual ~Base() = default; };
+class Derived1 : public Base { public: void run() override { std::cout << "D1\n"; } };
+class Derived2 : public Base { public: void run() override { std::cout << "D2\n"; } };
+
+// transform every value through a non-owning callback, no template bloat per caller
+void applyAll(vector<int>& values, FunctionRef<int(int)> op) {
+    for (auto& v : values) v = op(v);
+}
+
+int main () {
+    cout << "\n\nProblem 1: Strategy pattern with InplaceFunction" << endl;
+    map<char, InplaceFunction<double(double, double)>> strategies;
+    strategies['+'] = [](double a, double b) { return a + b; };
+    strategies['-'] = [](double a, double b) { return a - b; };
+    strategies['*'] = [](double a, double b) { return a * b; };
+    strategies['/'] = [](double a, double b) { return a / b; };
+    for (char op : {'+', '-', '*', '/'}) {
+        cout << "8 " << op << " 2 = " << strategies[op](8, 2) << endl;
+    }
+    int offset = 10;
+    vector<int> values = {1, 2, 3};
+    applyAll(values, [offset](int x) { return x + offset; });
+    cout << "FunctionRef applied: " << values[0] << " " << values[1] << " " << values[2] << endl;
+
+    cout << "\n\nProblem 2: Event with unsubscribe token and batch notify" << endl;
+    Event<int> event;
+    auto printer = event.subscribe([](int v) { cout << "subscriber A got " << v << endl; });
+    event.subscribe([](std::span<const int> batch) {
+        cout << "subscriber B got a batch of " << batch.size() << endl;
+    });
+    event.notify(42);
+    event.unsubscribe(printer);
+    vector<int> batch = {1, 2, 3, 4};
+    event.notify(std::span<const int>(batch));
+    // one-shot subscriber that removes itself and adds a replacement from inside notify()
+    Event<int>::Token once = 0;
+    once = event.subscribe([&](int v) {
+        cout << "one-shot got " << v << ", handing over" << endl;
+        event.unsubscribe(once);
+        event.subscribe([](int v) { cout << "replacement got " << v << endl; });
+    });
+    event.notify(7);
+    event.notify(8);
+    cout << event.size() << " subscribers left" << endl;
+
+    cout << "\n\nProblem 3: Factory registry with InplaceFunction on a perfect hash" << endl;
+    FrozenRegistry<InplaceFunction<unique_ptr<Base>()>> registry;
+    registry.add("d1", [] { return std::make_unique<Derived1>(); });
+    registry.add("d2", [] { return std::make_unique<Derived2>(); });
+    registry.freeze();
+    for (const auto& name : {"d1", "d2", "d3"}) {
+        if (auto factory = registry.find(name)) (*factory)()->run();
+        else cout << "unknown type " << name << endl;
+    }
+
+    cout << "\n\nProblem 4: Compare 10 subscribers x 10 million notifications" << endl;
+    const int nSubscribers = 10;
+    const int nValues = 10'000'000;
+    vector<int> stream(nValues);
+    std::iota(stream.begin(), stream.end(), 0);
+    vector<long long> sums(nSubscribers, 0);
+
+    FunctionEvent functionEvent;
+    for (int i = 0; i < nSubscribers; ++i) {
+        functionEvent.subscribe([&sums, i](int v) { sums[i] += v; });
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int v : stream) functionEvent.notify(v);
+    auto end = std::chrono::high_resolution_clock::now();
+    cout << "std::function Event, per value:  "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (sum " << sums[0] << ")" << endl;
+
+    std::fill(sums.begin(), sums.end(), 0);
+    Event<int> inplaceEvent;
+    for (int i = 0; i < nSubscribers; ++i) {
+        inplaceEvent.subscribe([&sums, i](int v) { sums[i] += v; });
+    }
+    start = std::chrono::high_resolution_clock::now();
+    for (int v : stream) inplaceEvent.notify(v);
+    end = std::chrono::high_resolution_clock::now();
+    cout << "InplaceFunction Event, per value: "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (sum " << sums[0] << ")" << endl;
+
+    std::fill(sums.begin(), sums.end(), 0);
+    start = std::chrono::high_resolution_clock::now();
+    const size_t batchSize = 4096;
+    for (size_t i = 0; i < stream.size(); i += batchSize) {
+        inplaceEvent.notify(std::span<const int>(stream).subspan(i, std::min(batchSize, stream.size() - i)));
+    }
+    end = std::chrono::high_resolution_clock::now();
+    cout << "InplaceFunction Event, batched:   "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (sum " << sums[0] << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <iostream>
+#include <vector>
+#include <variant>
+#include <array>
+#include <tuple>
+#include <string_view>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <span>
+#include <stdexcept>
+using namespace std;
+
+template<typename... Ts>
+struct TypeList {
+    static constexpr size_t size = sizeof...(Ts);
+};
+
+// position of T in TypeList<Ts...>, compile error if missing
+template<typename T, typename List>
+struct IndexOf;
+template<typename T, typename... Ts>
+struct IndexOf<T, TypeList<Ts...>> {
+    static constexpr size_t value = [] {
+        constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+        for (size_t i = 0; i < sizeof...(Ts); ++i) {
+            if (matches[i]) return i;
+        }
+        return sizeof...(Ts);
+    }();
+    static_assert(value < sizeof...(Ts), "type is not in the list");
+};
+
+template<typename From, typename Event, typename To>
+struct Transition {};
+
+// States, events and transitions are all types; the transition table is folded into
+// a constexpr [state][event] array so dispatch is a single indexed load, no if-chain.
+// Events without a transition leave the state unchanged.
+template<typename States, typename Events, typename... Transitions>
+class StateMachine {
+public:
+    using StateId = uint8_t;
+    using EventId = uint8_t;
+    static constexpr size_t nStates = States::size;
+    static constexpr size_t nEvents = Events::size;
+    static_assert(nStates <= 256 && nEvents <= 256, "ids are stored as uint8_t");
+
+    template<typename S>
+    static constexpr StateId stateId = static_cast<StateId>(IndexOf<S, States>::value);
+    template<typename E>
+    static constexpr EventId eventId = static_cast<EventId>(IndexOf<E, Events>::value);
+
+    static constexpr StateId next(StateId s, EventId e) { return table[s][e]; }
+
+    // jump table over the state types, like std::visit without the variant
+    template<typename Func>
+    static decltype(auto) visit(StateId s, Func&& func) {
+        return visitImpl(s, std::forward<Func>(func), States{});
+    }
+
+    // Many machines stored struct-of-arrays: one byte of state per machine.
+    class Batch {
+    public:
+        explicit Batch(size_t n, StateId initial = 0) : states(n, initial) {
+            if (initial >= nStates) throw std::invalid_argument("initial state id out of range");
+        }
+
+        // events[i] is delivered to machine i, one event per machine
+        void process(std::span<const EventId> events) {
+            const size_t n = states.size();
+            if (events.size() != n) throw std::invalid_argument("process() needs one event per machine");
+            const EventId* e = events.data();
+            // validate first, a separate branch-free pass keeps the transition loop tight
+            bool outOfRange = false;
+            for (size_t i = 0; i < n; ++i) outOfRange |= e[i] >= nEvents;
+            if (outOfRange) throw std::invalid_argument("event id out of range");
+            StateId* s = states.data();
+            for (size_t i = 0; i < n; ++i) {
+                s[i] = flatTable[s[i] * nEvents + e[i]];
+            }
+        }
+        // same event to every machine
+        template<typename E>
+        void broadcast() {
+            constexpr EventId e = eventId<E>;
+            for (auto& s : states) s = flatTable[s * nEvents + e];
+        }
+        array<size_t, nStates> histogram() const {
+            array<size_t, nStates> counts{};
+            for (auto s : states) ++counts[s];
+            return counts;
+        }
+        StateId operator[](size_t i) const { return states[i]; }
+        size_t size() const { return states.size(); }
+    private:
+        vector<StateId> states;
+    };
+private:
+    using Table = array<array<StateId, nEvents>, nStates>;
+
+    template<typename From, typename Event, typename To>
+    static constexpr void apply(Table& t, Transition<From, Event, To>) {
+        t[stateId<From>][eventId<Event>] = stateId<To>;
+    }
+    static constexpr Table buildTable() {
+        Table t{};
+        for (size_t s = 0; s < nStates; ++s) {
+            for (size_t e = 0; e < nEvents; ++e) t[s][e] = static_cast<StateId>(s);
+        }
+        (apply(t, Transitions{}), ...);
+        return t;
+    }
+    static constexpr array<StateId, nStates * nEvents> flatten(const Table& t) {
+        array<StateId, nStates * nEvents> flat{};
+        for (size_t s = 0; s < nStates; ++s) {
+            for (size_t e = 0; e < nEvents; ++e) flat[s * nEvents + e] = t[s][e];
+        }
+        return flat;
+    }
+    template<typename Func, typename... Ss>
+    static decltype(auto) visitImpl(StateId s, Func&& func, TypeList<Ss...>) {
+        using R = std::invoke_result_t<Func, std::tuple_element_t<0, std::tuple<Ss...>>>;
+        using Thunk = R (*)(Func&&);
+        static constexpr Thunk thunks[] = {
+            [](Func&& f) -> R { return std::forward<Func>(f)(Ss{}); }...
+        };
+        return thunks[s](std::forward<Func>(func));
+    }
+
+    static constexpr Table table = buildTable();
+    static constexpr auto flatTable = flatten(table);
+};
+
+// RPG character states from ch9 project two
+struct Idle      { static constexpr std::string_view name = "Idle"; };
+struct Running   { static constexpr std::string_view name = "Running"; };
+struct Attacking { static constexpr std::string_view name = "Attacking"; };
+struct Dead      { static constexpr std::string_view name = "Dead"; };
+
+struct Move {};
+struct Stop {};
+struct Attack {};
+struct Die {};
+
+using Character = StateMachine<
+    TypeList<Idle, Running, Attacking, Dead>,
+    TypeList<Move, Stop, Attack, Die>,
+    Transition<Idle, Move, Running>,
+    Transition<Idle, Attack, Attacking>,
+    Transition<Running, Stop, Idle>,
+    Transition<Running, Attack, Attacking>,
+    Transition<Attacking, Stop, Idle>,
+    Transition<Attacking, Move, Running>,
+    Transition<Idle, Die, Dead>,
+    Transition<Running, Die, Dead>,
+    Transition<Attacking, Die, Dead>
+>;
+
+static_assert(Character::next(Character::stateId<Idle>, Character::eventId<Move>) == Character::stateId<Running>);
+static_assert(Character::next(Character::stateId<Dead>, Character::eventId<Move>) == Character::stateId<Dead>);
+
+// the handout's variant + visit version, one object per character
+using VariantState = std::variant<Idle, Running, Attacking, Dead>;
+
+VariantState onEvent(const VariantState& state, uint8_t event) {
+    return std::visit([event](const auto& s) -> VariantState {
+        using S = std::decay_t<decltype(s)>;
+        if constexpr (std::is_same_v<S, Dead>) {
+            return s;
+        } else {
+            if (event == 0) return Running{};
+            if (event == 1) return Idle{};
+            if (event == 2) return Attacking{};
+            return Dead{};
+        }
+    }, state);
+}
+
+int main() {
+    cout << "\n\nProblem 1: Character state machine from a type-level transition table" << endl;
+    Character::StateId hero = Character::stateId<Idle>;
+    for (Character::EventId e : {Character::eventId<Move>, Character::eventId<Attack>,
+                                 Character::eventId<Stop>, Character::eventId<Die>, Character::eventId<Move>}) {
+        hero = Character::next(hero, e);
+        Character::visit(hero, [](auto state) { cout << "Hero is " << decltype(state)::name << endl; });
+    }
+
+    cout << "\n\nProblem 2: 1 million characters x 100 ticks" << endl;
+    const size_t nCharacters = 1'000'000;
+    const int nTicks = 100;
+    std::mt19937 rng(1);
+    // mostly movement, rarely death
+    vector<vector<uint8_t>> ticks(nTicks, vector<uint8_t>(nCharacters));
+    for (auto& events : ticks) {
+        for (auto& e : events) {
+            unsigned r = rng() % 1000;
+            e = r == 0 ? 3 : static_cast<uint8_t>(r % 3);
+        }
+    }
+
+    vector<VariantState> objects(nCharacters, Idle{});
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& events : ticks) {
+        for (size_t i = 0; i < nCharacters; ++i) {
+            objects[i] = onEvent(objects[i], events[i]);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    size_t deadObjects = 0;
+    for (const auto& o : objects) deadObjects += std::holds_alternative<Dead>(o);
+    cout << "variant + visit:       " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, dead: " << deadObjects << endl;
+
+    Character::Batch batch(nCharacters);
+    start = std::chrono::high_resolution_clock::now();
+    for (const auto& events : ticks) {
+        batch.process(events);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto counts = batch.histogram();
+    cout << "StateMachine::Batch:   " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, dead: " << counts[Character::stateId<Dead>] << endl;
+
+    batch.broadcast<Stop>();
+    counts = batch.histogram();
+    cout << "After broadcasting Stop: Idle " << counts[Character::stateId<Idle>]
+         << ", Running " << counts[Character::stateId<Running>]
+         << ", Attacking " << counts[Character::stateId<Attacking>]
+         << ", Dead " << counts[Character::stateId<Dead>] << endl;
+    return 0;
+}
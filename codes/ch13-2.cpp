@@ -0,0 +1,224 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <variant>
+#include <span>
+#include <stdexcept>
+#include <random>
+#include <chrono>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+template<typename E>
+struct Unexpected {
+    E error;
+};
+
+// Value or error, returned instead of thrown. The happy path is a tag check,
+// no unwinding tables are touched and nothing is allocated.
+template<typename T, typename E>
+class Expected {
+public:
+    Expected(T value) : storage(std::in_place_index<0>, std::move(value)) {}
+    Expected(Unexpected<E> err) : storage(std::in_place_index<1>, std::move(err.error)) {}
+
+    bool has_value() const { return storage.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+    const T& value() const& {
+        if (!has_value()) throw std::logic_error("Expected has no value");
+        return std::get<0>(storage);
+    }
+    const T& operator*() const { return std::get<0>(storage); }
+    const E& error() const { return std::get<1>(storage); }
+    T value_or(T fallback) const { return has_value() ? std::get<0>(storage) : fallback; }
+
+    // f(T) -> Expected<U, E>; errors pass through untouched
+    template<typename F>
+    auto and_then(F&& f) const {
+        using R = std::invoke_result_t<F, const T&>;
+        if (has_value()) return std::forward<F>(f)(std::get<0>(storage));
+        return R(Unexpected<E>{error()});
+    }
+    // f(T) -> U, wrapped back into Expected<U, E>
+    template<typename F>
+    auto transform(F&& f) const {
+        using U = std::invoke_result_t<F, const T&>;
+        if (has_value()) return Expected<U, E>(std::forward<F>(f)(std::get<0>(storage)));
+        return Expected<U, E>(Unexpected<E>{error()});
+    }
+    // f(E) -> Expected<T, E>, a chance to recover
+    template<typename F>
+    Expected or_else(F&& f) const {
+        if (has_value()) return *this;
+        return std::forward<F>(f)(error());
+    }
+private:
+    std::variant<T, E> storage;
+};
+
+enum class ErrorCode : uint8_t { None, NegativeId, DivisionByZero };
+
+std::string_view describe(ErrorCode e) {
+    switch (e) {
+    case ErrorCode::NegativeId: return "Negative ID is not allowed";
+    case ErrorCode::DivisionByZero: return "Division by zero is not allowed.";
+    default: return "OK";
+    }
+}
+
+// ch13.cpp divide and ch8.cpp parseId, one version per error style
+double divide(int a, int b) {
+    if (b == 0) {
+        throw std::invalid_argument("Division by zero is not allowed.");
+    }
+    return static_cast<double>(a) / b;
+}
+
+std::optional<double> divideOpt(int a, int b) {
+    if (b == 0) return std::nullopt;
+    return static_cast<double>(a) / b;
+}
+
+Expected<double, ErrorCode> tryDivide(int a, int b) {
+    if (b == 0) return Unexpected<ErrorCode>{ErrorCode::DivisionByZero};
+    return static_cast<double>(a) / b;
+}
+
+Expected<int, ErrorCode> parseId(int value) {
+    if (value < 0) return Unexpected<ErrorCode>{ErrorCode::NegativeId};
+    return value;
+}
+
+struct Record {
+    int id;
+    int a;
+    int b;
+};
+
+// Batch validation: one bit per row (1 = rejected) plus the first error of every bad row.
+// Each rule is evaluated branch-free over the whole batch before anything is reported.
+struct Validation {
+    vector<uint64_t> rejected;
+    vector<std::pair<size_t, ErrorCode>> errors;
+
+    bool isRejected(size_t row) const { return rejected[row / 64] >> (row % 64) & 1; }
+    size_t rejectedCount() const {
+        size_t cnt = 0;
+        for (auto w : rejected) cnt += std::popcount(w);
+        return cnt;
+    }
+};
+
+Validation validateBatch(std::span<const Record> records, bool collectErrors = true) {
+    Validation result;
+    result.rejected.assign((records.size() + 63) / 64, 0);
+    for (size_t w = 0; w < result.rejected.size(); ++w) {
+        uint64_t bits = 0;
+        size_t end = std::min(records.size(), (w + 1) * 64);
+        for (size_t i = w * 64; i < end; ++i) {
+            bool bad = (records[i].id < 0) | (records[i].b == 0);
+            bits |= static_cast<uint64_t>(bad) << (i % 64);
+        }
+        result.rejected[w] = bits;
+    }
+    if (collectErrors) {
+        for (size_t w = 0; w < result.rejected.size(); ++w) {
+            for (uint64_t bits = result.rejected[w]; bits; bits &= bits - 1) {
+                size_t row = w * 64 + std::countr_zero(bits);
+                auto code = records[row].id < 0 ? ErrorCode::NegativeId : ErrorCode::DivisionByZero;
+                result.errors.push_back({row, code});
+            }
+        }
+    }
+    return result;
+}
+
+int main () {
+    cout << "\n\nProblem 1: Expected with monadic chaining" << endl;
+    for (auto [id, a, b] : {Record{7, 10, 2}, Record{-1, 10, 2}, Record{3, 10, 0}}) {
+        auto result = parseId(id)
+            .and_then([&](int) { return tryDivide(a, b); })
+            .transform([](double q) { return q * 100; });
+        if (result) {
+            cout << "record " << id << ": " << *result << endl;
+        } else {
+            cout << "record " << id << ": " << describe(result.error()) << endl;
+        }
+    }
+    auto recovered = tryDivide(1, 0).or_else([](ErrorCode) { return Expected<double, ErrorCode>(0.0); });
+    cout << "1 / 0 recovered as " << recovered.value() << endl;
+
+    cout << "\n\nProblem 2: Batch validation with a rejection bitmap" << endl;
+    vector<Record> rows = {{1, 4, 2}, {-5, 1, 1}, {2, 9, 0}, {3, 8, 4}};
+    auto validation = validateBatch(rows);
+    for (auto [row, code] : validation.errors) {
+        cout << "row " << row << " rejected: " << describe(code) << endl;
+    }
+    cout << validation.rejectedCount() << " of " << rows.size() << " rows rejected" << endl;
+
+    cout << "\n\nProblem 3: throw vs optional vs Expected vs batch at different error rates" << endl;
+    const size_t nRecords = 2'000'000; // throw at 50% takes seconds already
+    for (double errorRate : {0.0, 0.01, 0.5}) {
+        std::mt19937 rng(5);
+        std::bernoulli_distribution isBad(errorRate);
+        vector<Record> records(nRecords);
+        for (auto& r : records) r = {1, static_cast<int>(rng() % 1000), isBad(rng) ? 0 : static_cast<int>(rng() % 100) + 1};
+        cout << "error rate " << errorRate * 100 << "%" << endl;
+
+        auto timeIt = [](const char* label, auto&& body) {
+            auto start = std::chrono::high_resolution_clock::now();
+            auto [sum, errors] = body();
+            auto end = std::chrono::high_resolution_clock::now();
+            cout << "  " << label << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                 << " ms (sum " << static_cast<long long>(sum) << ", rejected " << errors << ")" << endl;
+        };
+        timeIt("throw:    ", [&] {
+            double sum = 0;
+            size_t errors = 0;
+            for (const auto& r : records) {
+                try {
+                    sum += divide(r.a, r.b);
+                } catch (const std::invalid_argument&) {
+                    ++errors;
+                }
+            }
+            return std::pair{sum, errors};
+        });
+        timeIt("optional: ", [&] {
+            double sum = 0;
+            size_t errors = 0;
+            for (const auto& r : records) {
+                if (auto q = divideOpt(r.a, r.b)) sum += *q;
+                else ++errors;
+            }
+            return std::pair{sum, errors};
+        });
+        timeIt("Expected: ", [&] {
+            double sum = 0;
+            size_t errors = 0;
+            for (const auto& r : records) {
+                auto q = tryDivide(r.a, r.b);
+                if (q) sum += *q;
+                else ++errors;
+            }
+            return std::pair{sum, errors};
+        });
+        timeIt("batch:    ", [&] {
+            auto v = validateBatch(records, false);
+            double sum = 0;
+            for (size_t i = 0; i < records.size(); ++i) {
+                // rejected rows divide by 1 and are masked out, no branch per row
+                bool bad = v.isRejected(i);
+                double q = static_cast<double>(records[i].a) / (bad ? 1 : records[i].b);
+                sum += bad ? 0.0 : q;
+            }
+            return std::pair{sum, v.rejectedCount()};
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+using namespace std;
+
+// Random access iterator over any column that returns string_view by value.
+// reference is a prvalue, so it is an input iterator in the legacy sense and a
+// random_access_iterator in the C++20 sense (same trick as std::views).
+template<typename Column>
+class ColumnIterator {
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::string_view;
+
+    ColumnIterator() = default;
+    ColumnIterator(const Column* col, size_t idx) : col(col), idx(idx) {}
+
+    std::string_view operator*() const { return (*col)[idx]; }
+    std::string_view operator[](difference_type n) const { return (*col)[idx + n]; }
+    ColumnIterator& operator++() { ++idx; return *this; }
+    ColumnIterator operator++(int) { auto tmp = *this; ++idx; return tmp; }
+    ColumnIterator& operator--() { --idx; return *this; }
+    ColumnIterator operator--(int) { auto tmp = *this; --idx; return tmp; }
+    ColumnIterator& operator+=(difference_type n) { idx += n; return *this; }
+    ColumnIterator& operator-=(difference_type n) { idx -= n; return *this; }
+    friend ColumnIterator operator+(ColumnIterator it, difference_type n) { return it += n; }
+    friend ColumnIterator operator+(difference_type n, ColumnIterator it) { return it += n; }
+    friend ColumnIterator operator-(ColumnIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const ColumnIterator& a, const ColumnIterator& b) {
+        return static_cast<difference_type>(a.idx) - static_cast<difference_type>(b.idx);
+    }
+    friend bool operator==(const ColumnIterator& a, const ColumnIterator& b) { return a.idx == b.idx; }
+    friend auto operator<=>(const ColumnIterator& a, const ColumnIterator& b) { return a.idx <=> b.idx; }
+private:
+    const Column* col = nullptr;
+    size_t idx = 0;
+};
+
+// All bytes live in one buffer, offsets[i]..offsets[i+1] is the i-th string.
+// Offsets are 32-bit to keep the per-row overhead at 4 bytes, which limits a
+// column to 4 GiB of string data and 2^32 - 1 rows; push_back throws past that.
+class StringColumn {
+public:
+    using iterator = ColumnIterator<StringColumn>;
+
+    StringColumn() : offsets{0} {}
+    StringColumn(std::initializer_list<std::string_view> init) : StringColumn() {
+        for (auto s : init) push_back(s);
+    }
+
+    void reserve(size_t n, size_t nBytes) {
+        offsets.reserve(n + 1);
+        bytes.reserve(nBytes);
+    }
+    void push_back(std::string_view s) {
+        if (s.size() > UINT32_MAX - bytes.size() || size() == UINT32_MAX) {
+            throw std::length_error("StringColumn is limited to 4 GiB and 2^32 - 1 rows");
+        }
+        bytes.append(s);
+        offsets.push_back(static_cast<uint32_t>(bytes.size()));
+    }
+    void clear() { bytes.clear(); offsets.assign(1, 0); }
+
+    std::string_view operator[](size_t i) const {
+        return std::string_view(bytes.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    size_t size() const { return offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+    size_t memoryUsage() const {
+        return bytes.capacity() + offsets.capacity() * sizeof(uint32_t);
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
+
+    // Strings cannot be swapped in place, so sort a permutation and rebuild.
+    template<typename Compare = std::less<>>
+    void sort(Compare comp = Compare{}) {
+        vector<uint32_t> order(size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return comp((*this)[a], (*this)[b]);
+        });
+        StringColumn sorted;
+        sorted.reserve(size(), bytes.size());
+        for (auto i : order) sorted.push_back((*this)[i]);
+        *this = std::move(sorted);
+    }
+private:
+    std::string bytes;
+    vector<uint32_t> offsets;
+};
+
+// Duplicate values share storage: each distinct string is stored once in a
+// StringColumn pool and rows hold a 32-bit id into it.
+class InternedStringColumn {
+public:
+    using iterator = ColumnIterator<InternedStringColumn>;
+
+    InternedStringColumn() : slots(16, EMPTY) {}
+    InternedStringColumn(std::initializer_list<std::string_view> init) : InternedStringColumn() {
+        for (auto s : init) push_back(s);
+    }
+
+    void reserve(size_t n) { ids.reserve(n); }
+    void push_back(std::string_view s) { ids.push_back(intern(s)); }
+
+    std::string_view operator[](size_t i) const { return pool[ids[i]]; }
+    uint32_t id(size_t i) const { return ids[i]; }
+    size_t size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+    size_t uniqueCount() const { return pool.size(); }
+    size_t memoryUsage() const {
+        return ids.capacity() * sizeof(uint32_t) + pool.memoryUsage() + slots.capacity() * sizeof(uint32_t);
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
+
+    // Only the ids move, the pool is left untouched.
+    template<typename Compare = std::less<>>
+    void sort(Compare comp = Compare{}) {
+        std::stable_sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) {
+            return comp(pool[a], pool[b]);
+        });
+    }
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    // open addressing over pool ids; views into the pool would dangle on growth
+    uint32_t intern(std::string_view s) {
+        size_t mask = slots.size() - 1;
+        for (size_t i = std::hash<std::string_view>{}(s) & mask;; i = (i + 1) & mask) {
+            if (slots[i] == EMPTY) {
+                uint32_t newId = static_cast<uint32_t>(pool.size());
+                pool.push_back(s);
+                slots[i] = newId;
+                if (pool.size() * 2 > slots.size()) rehash();
+                return newId;
+            }
+            if (pool[slots[i]] == s) return slots[i];
+        }
+    }
+    void rehash() {
+        vector<uint32_t> bigger(slots.size() * 2, EMPTY);
+        size_t mask = bigger.size() - 1;
+        for (uint32_t id = 0; id < pool.size(); ++id) {
+            size_t i = std::hash<std::string_view>{}(pool[id]) & mask;
+            while (bigger[i] != EMPTY) i = (i + 1) & mask;
+            bigger[i] = id;
+        }
+        slots = std::move(bigger);
+    }
+
+    StringColumn pool;
+    vector<uint32_t> ids;
+    vector<uint32_t> slots;
+};
+
+template<typename Column>
+void printColumn(const Column& col) {
+    for (auto s : col) {
+        cout << s << " ";
+    }
+    cout << endl;
+}
+
+int main () {
+    cout << "\n\nProblem 1: Store 2 million \"text\" in vector<string>, StringColumn and InternedStringColumn" << std::endl;
+    int cnt = 2'000'000;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<string> vec;
+    for (int i = 0; i < cnt; ++i) {
+        vec.emplace_back("text");
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    size_t vecBytes = vec.capacity() * sizeof(string); // SSO keeps "text" inline
+    cout << "vector<string>:       " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, " << vecBytes / 1024 << " KB" << endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    StringColumn column;
+    for (int i = 0; i < cnt; ++i) {
+        column.push_back("text");
+    }
+    end = std::chrono::high_resolution_clock::now();
+    cout << "StringColumn:         " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, " << column.memoryUsage() / 1024 << " KB" << endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    InternedStringColumn interned;
+    for (int i = 0; i < cnt; ++i) {
+        interned.push_back("text");
+    }
+    end = std::chrono::high_resolution_clock::now();
+    cout << "InternedStringColumn: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, " << interned.memoryUsage() / 1024 << " KB, " << interned.uniqueCount() << " unique" << endl;
+
+    cout << "\n\nProblem 2: Scan all strings and count total length" << std::endl;
+    start = std::chrono::high_resolution_clock::now();
+    size_t totalVec = 0;
+    for (const auto& s : vec) totalVec += s.size();
+    end = std::chrono::high_resolution_clock::now();
+    cout << "vector<string>: " << totalVec << " bytes in "
+         << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us" << endl;
+    start = std::chrono::high_resolution_clock::now();
+    size_t totalCol = 0;
+    for (auto s : column) totalCol += s.size();
+    end = std::chrono::high_resolution_clock::now();
+    cout << "StringColumn:   " << totalCol << " bytes in "
+         << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us" << endl;
+
+    cout << "\n\nProblem 3: sort and count_if with lambdas on a StringColumn" << std::endl;
+    StringColumn names = {"Alice", "Bob", "Charlie", "David"};
+    names.sort([](string_view a, string_view b) {
+        return a.size() > b.size(); // Sort names by length, longest first
+    });
+    printColumn(names);
+
+    InternedStringColumn words = {"apple", "banana", "cherry", "date", "elderberry", "fig", "grape", "apple", "fig"};
+    int longWords = std::count_if(words.begin(), words.end(), [](string_view word) {
+        return word.length() > 5;
+    });
+    cout << "Number of words longer than 5 characters: " << longWords << endl;
+    words.sort();
+    printColumn(words);
+    cout << words.size() << " words, " << words.uniqueCount() << " unique" << endl;
+    return 0;
+}
@@ -0,0 +1,329 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <queue>
+#include <condition_variable>
+#include <functional>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <bit>
+#include <cstdint>
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+using namespace std;
+
+// Nanosecond timestamps. On x86-64 this reads the TSC (a few cycles, no syscall)
+// and converts with a ratio measured against steady_clock at startup;
+// elsewhere it falls back to steady_clock.
+class TraceClock {
+public:
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(_M_X64)
+        const Calibration& c = calibration(); // before reading the TSC, the first call calibrates
+        return static_cast<uint64_t>((__rdtsc() - c.tsc0) * c.nsPerTick);
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+private:
+    struct Calibration {
+        uint64_t tsc0 = 0;
+        double nsPerTick = 1.0;
+    };
+    static const Calibration& calibration() {
+        static const Calibration c = [] {
+            Calibration c;
+#if defined(__x86_64__) || defined(_M_X64)
+            auto t0 = std::chrono::steady_clock::now();
+            uint64_t r0 = __rdtsc();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            auto t1 = std::chrono::steady_clock::now();
+            uint64_t r1 = __rdtsc();
+            c.tsc0 = r0;
+            c.nsPerTick = std::chrono::duration<double, std::nano>(t1 - t0).count() / (r1 - r0);
+#endif
+            return c;
+        }();
+        return c;
+    }
+};
+
+struct TraceEvent {
+    const char* name; // must be a string literal or otherwise outlive the tracer
+    uint64_t start;
+    uint64_t end;
+};
+
+// One per recording thread, written only by its current owner. head is published
+// with release after the slot is filled, so the exporter never sees a half-written
+// event. When full the ring wraps and the oldest events are overwritten.
+class TraceBuffer {
+public:
+    static constexpr size_t capacity = 1 << 16;
+
+    explicit TraceBuffer(int tid) : tid(tid) {}
+    void push(const TraceEvent& e) {
+        size_t h = head.load(std::memory_order_relaxed);
+        events[h % capacity] = e;
+        head.store(h + 1, std::memory_order_release);
+    }
+    template<typename Func>
+    void forEach(Func func) const {
+        size_t h = head.load(std::memory_order_acquire);
+        for (size_t i = h > capacity ? h - capacity : 0; i < h; ++i) func(events[i % capacity]);
+    }
+    const int tid;
+private:
+    std::array<TraceEvent, capacity> events;
+    std::atomic<size_t> head{0};
+};
+
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+    // The registry lock is only taken the first time a thread records and when it
+    // exits. An exiting thread hands its buffer back with its events intact and
+    // the next new thread continues in it, so memory is bounded by the peak number
+    // of threads recording at once (1.5 MB each), not by how many were ever started.
+    // A buffer is one "tid" lane in the trace, shared by threads that ran one after another.
+    TraceBuffer& local() {
+        struct Owner {
+            TraceBuffer* buffer = nullptr;
+            ~Owner() {
+                if (buffer) Tracer::instance().release(buffer);
+            }
+        };
+        thread_local Owner owner;
+        if (!owner.buffer) owner.buffer = acquire();
+        return *owner.buffer;
+    }
+    void record(const char* name, uint64_t start, uint64_t end) { local().push({name, start, end}); }
+    size_t bufferCount() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return buffers.size();
+    }
+
+    // chrome://tracing or ui.perfetto.dev; call after the traced threads are done
+    void exportChromeTrace(const string& path) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::ofstream out(path);
+        out << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto& b : buffers) {
+            b->forEach([&](const TraceEvent& e) {
+                out << (first ? "" : ",") << "\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->tid
+                    << ",\"ts\":" << std::fixed << std::setprecision(3) << e.start / 1000.0
+                    << ",\"dur\":" << (e.end - e.start) / 1000.0 << "}";
+                first = false;
+            });
+        }
+        out << "\n]}\n";
+    }
+
+    // per-scope latency: count, p50/p99 from log2 buckets, and the bucket counts
+    void printHistograms() {
+        std::lock_guard<std::mutex> lock(mtx);
+        map<string, array<size_t, 64>> hist;
+        for (const auto& b : buffers) {
+            b->forEach([&](const TraceEvent& e) {
+                ++hist[e.name][std::min<size_t>(std::bit_width(e.end - e.start), 63)];
+            });
+        }
+        cout << setw(16) << "Scope" << setw(10) << "Count" << setw(12) << "p50 (us)" << setw(12) << "p99 (us)"
+             << "  log2(ns) buckets" << endl;
+        for (const auto& [name, buckets] : hist) {
+            size_t total = std::accumulate(buckets.begin(), buckets.end(), size_t(0));
+            auto quantile = [&](double q) {
+                size_t seen = 0;
+                for (size_t i = 0; i < buckets.size(); ++i) {
+                    seen += buckets[i];
+                    if (seen > q * total) return (i == 0 ? 0 : (uint64_t(1) << i)) / 1000.0; // bucket upper bound
+                }
+                return 0.0;
+            };
+            cout << setw(16) << name << setw(10) << total << setw(12) << fixed << setprecision(1) << quantile(0.5)
+                 << setw(12) << quantile(0.99) << "  ";
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                if (buckets[i]) cout << i << ":" << buckets[i] << " ";
+            }
+            cout << endl;
+        }
+    }
+private:
+    TraceBuffer* acquire() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!freeBuffers.empty()) {
+            TraceBuffer* b = freeBuffers.back();
+            freeBuffers.pop_back();
+            return b;
+        }
+        buffers.push_back(std::make_unique<TraceBuffer>(static_cast<int>(buffers.size())));
+        return buffers.back().get();
+    }
+    void release(TraceBuffer* b) {
+        std::lock_guard<std::mutex> lock(mtx);
+        freeBuffers.push_back(b);
+    }
+
+    std::mutex mtx;
+    vector<std::unique_ptr<TraceBuffer>> buffers; // kept for export, recycled through freeBuffers
+    vector<TraceBuffer*> freeBuffers;             // owner thread has exited
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), start(TraceClock::now()) {}
+    ~TraceScope() { Tracer::instance().record(name, start, TraceClock::now()); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+// statistics::calc from ch9-1.cpp, instrumented: "calc.queue" is submit -> task start,
+// "calc.compute" is the task body, "calc.gather" is the caller waiting on futures.
+template<typename T>
+vector<T> calc(const vector<int>& v, function<T(const vector<int>&)> func, int nThread) {
+    TRACE_SCOPE("calc");
+    vector<future<T>> futures;
+    futures.reserve(nThread);
+    for (int i = 0; i < nThread; ++i) {
+        uint64_t submitted = TraceClock::now();
+        futures.emplace_back(async(launch::async, [&v, &func, i, nThread, submitted] {
+            Tracer::instance().record("calc.queue", submitted, TraceClock::now());
+            TRACE_SCOPE("calc.compute");
+            return func(vector<int>(v.begin() + i * v.size() / nThread, v.begin() + (i + 1) * v.size() / nThread));
+        }));
+    }
+    TRACE_SCOPE("calc.gather");
+    vector<T> results;
+    results.reserve(nThread);
+    for (auto& fut : futures) {
+        results.push_back(fut.get());
+    }
+    return results;
+}
+
+// Minimal thread pool with the same instrumentation split between queueing and work.
+class ThreadPool {
+public:
+    explicit ThreadPool(int nThreads) {
+        for (int i = 0; i < nThreads; ++i) {
+            workers.emplace_back([this] { run(); });
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+    void submit(function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push({std::move(task), TraceClock::now()});
+        }
+        cv.notify_one();
+    }
+private:
+    struct Job {
+        function<void()> task;
+        uint64_t submitted;
+    };
+    void run() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+                job = std::move(tasks.front());
+                tasks.pop();
+            }
+            Tracer::instance().record("pool.queue", job.submitted, TraceClock::now());
+            TRACE_SCOPE("pool.task");
+            job.task();
+        }
+    }
+    vector<std::thread> workers;
+    std::queue<Job> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+};
+
+int main() {
+    cout << "\n\nProblem 1: Trace statistics::calc tasks" << endl;
+    vector<int> v(20'000'000);
+    std::iota(v.begin(), v.end(), 0);
+    for (int nThread : {1, 2, 4, 8}) {
+        auto maxes = calc<int>(v, [](const vector<int>& sub_v) { return *max_element(sub_v.begin(), sub_v.end()); }, nThread);
+        cout << nThread << " threads, max " << *max_element(maxes.begin(), maxes.end()) << endl;
+    }
+    // 15 async threads recorded, but at most 8 + main at once
+    cout << "Trace buffers allocated: " << Tracer::instance().bufferCount() << endl;
+
+    cout << "\n\nProblem 2: Trace a thread pool" << endl;
+    std::atomic<long long> total{0};
+    {
+        ThreadPool pool(4);
+        for (int i = 0; i < 2000; ++i) {
+            pool.submit([&total, i] {
+                long long s = 0;
+                for (int k = 0; k < 20'000; ++k) s += (k ^ i) & 7;
+                total += s;
+            });
+        }
+    } // pool destructor drains the queue
+    cout << "2000 tasks done, total " << total << endl;
+
+    cout << "\n\nProblem 3: Trace the ch7 async accumulate" << endl;
+    {
+        TRACE_SCOPE("async.total");
+        vector<int> large_vector(50'000'000, 1);
+        uint64_t submitted = TraceClock::now();
+        std::future<long long> fut = std::async(std::launch::async, [&large_vector, submitted] {
+            Tracer::instance().record("async.queue", submitted, TraceClock::now());
+            TRACE_SCOPE("async.accumulate");
+            return std::accumulate(large_vector.begin(), large_vector.end(), 0LL);
+        });
+        cout << "The sum of the large vector is: " << fut.get() << endl;
+    }
+
+    cout << "\n\nProblem 4: Per-scope latency and Chrome trace export" << endl;
+    Tracer::instance().printHistograms();
+    Tracer::instance().exportChromeTrace("trace.json");
+    cout << "Wrote trace.json, open it in chrome://tracing or ui.perfetto.dev" << endl;
+
+    // cost of one empty scope
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 1'000'000; ++i) {
+        TRACE_SCOPE("overhead");
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    cout << "TRACE_SCOPE overhead: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1'000'000
+         << " ns per scope" << endl;
+    return 0;
+}
@@ -0,0 +1,261 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <bit>
+#include <cstdint>
+using namespace std;
+
+constexpr size_t kCacheLine = 64;
+constexpr size_t kShards = 64; // threads beyond this share shards, still correct, just not contention free
+
+// Every thread gets a fixed shard index the first time it touches any metric.
+inline size_t threadShard() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return shard;
+}
+
+// Hot-path writes go to the calling thread's own cache line with relaxed atomics,
+// so increments from different cores never touch the same line. Reads walk all
+// shards and sum, they are cheap enough for a scrape but not for the hot path.
+// Updates are const so metrics can be bumped from const methods, like ch15's Timer.
+class Counter {
+public:
+    void inc(uint64_t n = 1) const { shards[threadShard()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const {
+        uint64_t total = 0;
+        for (const auto& s : shards) total += s.value.load(std::memory_order_relaxed);
+        return total;
+    }
+private:
+    struct alignas(kCacheLine) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    mutable std::array<Shard, kShards> shards;
+};
+
+// Up/down value such as in-flight tasks or queue depth. A thread may add on one
+// shard and subtract on another, only the sum is meaningful.
+class Gauge {
+public:
+    void add(int64_t n = 1) const { shards[threadShard()].value.fetch_add(n, std::memory_order_relaxed); }
+    void sub(int64_t n = 1) const { add(-n); }
+    int64_t value() const {
+        int64_t total = 0;
+        for (const auto& s : shards) total += s.value.load(std::memory_order_relaxed);
+        return total;
+    }
+private:
+    struct alignas(kCacheLine) Shard {
+        std::atomic<int64_t> value{0};
+    };
+    mutable std::array<Shard, kShards> shards;
+};
+
+// Latency histogram in log2(ns) buckets, same layout as the ch15-2 tracer.
+class Histogram {
+public:
+    static constexpr size_t nBuckets = 64;
+
+    struct Snapshot {
+        std::array<uint64_t, nBuckets> buckets{};
+        uint64_t count = 0;
+        uint64_t sumNs = 0;
+
+        // upper bound of the bucket holding the q-quantile
+        uint64_t quantileNs(double q) const {
+            uint64_t seen = 0;
+            for (size_t i = 0; i < nBuckets; ++i) {
+                seen += buckets[i];
+                if (seen > q * count) return i == 0 ? 0 : uint64_t(1) << i;
+            }
+            return 0;
+        }
+    };
+
+    void record(uint64_t ns) const {
+        Shard& s = shards[threadShard()];
+        s.buckets[std::min<size_t>(std::bit_width(ns), nBuckets - 1)].fetch_add(1, std::memory_order_relaxed);
+        s.sumNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+    Snapshot snapshot() const {
+        Snapshot snap;
+        for (const auto& s : shards) {
+            for (size_t i = 0; i < nBuckets; ++i) snap.buckets[i] += s.buckets[i].load(std::memory_order_relaxed);
+            snap.sumNs += s.sumNs.load(std::memory_order_relaxed);
+        }
+        snap.count = std::accumulate(snap.buckets.begin(), snap.buckets.end(), uint64_t(0));
+        return snap;
+    }
+private:
+    struct alignas(kCacheLine) Shard {
+        std::array<std::atomic<uint64_t>, nBuckets> buckets{};
+        std::atomic<uint64_t> sumNs{0};
+    };
+    mutable std::array<Shard, kShards> shards;
+};
+
+// Named metrics. Lookup takes a lock, so call sites resolve a metric once and keep
+// the reference; metrics are never removed, references stay valid for the program.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+    const Counter& counter(const string& name) { return get(counters, name); }
+    const Gauge& gauge(const string& name) { return get(gauges, name); }
+    const Histogram& histogram(const string& name) { return get(histograms, name); }
+
+    // one metric per line, histograms as count/sum/quantiles, Prometheus-like text
+    string snapshot() {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::ostringstream out;
+        for (const auto& [name, c] : counters) out << name << " " << c->value() << "\n";
+        for (const auto& [name, g] : gauges) out << name << " " << g->value() << "\n";
+        for (const auto& [name, h] : histograms) {
+            auto snap = h->snapshot();
+            out << name << "_count " << snap.count << "\n"
+                << name << "_sum_ns " << snap.sumNs << "\n"
+                << name << "{quantile=\"0.5\"} " << snap.quantileNs(0.5) << "\n"
+                << name << "{quantile=\"0.99\"} " << snap.quantileNs(0.99) << "\n";
+        }
+        return out.str();
+    }
+private:
+    template<typename Metric>
+    const Metric& get(map<string, std::unique_ptr<Metric>>& metrics, const string& name) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto& slot = metrics[name];
+        if (!slot) slot = std::make_unique<Metric>();
+        return *slot;
+    }
+
+    std::mutex mtx;
+    map<string, std::unique_ptr<Counter>> counters;
+    map<string, std::unique_ptr<Gauge>> gauges;
+    map<string, std::unique_ptr<Histogram>> histograms;
+};
+
+// RAII latency sample
+class ScopedLatency {
+public:
+    explicit ScopedLatency(const Histogram& histogram) : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+private:
+    const Histogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+// ch15's Timer on top of the registry: call() stays const and is now safe to call
+// from any number of threads.
+class Timer {
+public:
+    explicit Timer(const string& name = "timer")
+        : calls(MetricsRegistry::instance().counter(name + "_calls")) {}
+    void call() const { calls.inc(); }
+    uint64_t getCount() const { return calls.value(); }
+private:
+    const Counter& calls;
+};
+
+// Shared counters for the contention benchmark
+struct MutexCounter {
+    void inc() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        ++value;
+    }
+    mutable std::mutex mtx;
+    mutable uint64_t value = 0;
+};
+
+struct AtomicCounter {
+    void inc() const { value.fetch_add(1, std::memory_order_relaxed); }
+    mutable std::atomic<uint64_t> value{0}; // one cache line bounced between all cores
+};
+
+template<typename C>
+long long hammer(const C& counter, int nThreads, int perThread) {
+    auto start = std::chrono::high_resolution_clock::now();
+    vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&counter, perThread] {
+            for (int i = 0; i < perThread; ++i) counter.inc();
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+int main() {
+    cout << "\n\nProblem 1: Timer called from 4 threads" << endl;
+    Timer timer;
+    {
+        vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&timer] {
+                for (int i = 0; i < 250'000; ++i) timer.call();
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+    cout << "Timer called " << timer.getCount() << " times (expected 1000000)" << endl;
+
+    cout << "\n\nProblem 2: Counters, gauges and latency histograms in a worker loop" << endl;
+    auto& registry = MetricsRegistry::instance();
+    const Counter& processed = registry.counter("jobs_processed");
+    const Counter& failed = registry.counter("jobs_failed");
+    const Gauge& inFlight = registry.gauge("jobs_in_flight");
+    const Histogram& latency = registry.histogram("job_latency");
+    {
+        vector<std::thread> workers;
+        for (int w = 0; w < 4; ++w) {
+            workers.emplace_back([&, w] {
+                for (int job = 0; job < 2'000; ++job) {
+                    inFlight.add();
+                    {
+                        ScopedLatency sample(latency);
+                        long long s = 0;
+                        for (int k = 0; k < 1'000 * (1 + job % 8); ++k) s += (k ^ w) & 3;
+                        if (s % 7 == 0) failed.inc();
+                    }
+                    processed.inc();
+                    inFlight.sub();
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+    cout << registry.snapshot();
+
+    cout << "\n\nProblem 3: Contended increments, mutex vs one atomic vs sharded counter" << endl;
+    const int perThread = 5'000'000;
+    cout << setw(8) << "Threads" << setw(12) << "mutex" << setw(12) << "atomic" << setw(12) << "sharded" << "  (ms)" << endl;
+    for (int nThreads : {1, 2, 4, 8}) {
+        MutexCounter m;
+        AtomicCounter a;
+        Counter c;
+        long long tm = hammer(m, nThreads, perThread);
+        long long ta = hammer(a, nThreads, perThread);
+        long long tc = hammer(c, nThreads, perThread);
+        cout << setw(8) << nThreads << setw(12) << tm << setw(12) << ta << setw(12) << tc << endl;
+        if (m.value != a.value || a.value.load() != c.value()) cout << "count mismatch!" << endl;
+    }
+    return 0;
+}
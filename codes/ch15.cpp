@@ -5,21 +5,22 @@
 #include <algorithm>
 #include <chrono>
 #include <execution>
+#include <atomic>
 using namespace std;
 
 class Timer 
 {
 public:
     void call() const {
-        ++cnt;
+        cnt.fetch_add(1, std::memory_order_relaxed); // atomic, so concurrent calls are not a data race
         // name += "test"; // uncommenting this line will cause a compilation error due to const correctness
     }
 
     int getCount() const {
-        return cnt;
+        return cnt.load(std::memory_order_relaxed);
     }
     private:
-    mutable int cnt = 0; // Counter for the number of calls
+    mutable std::atomic<int> cnt{0}; // Counter for the number of calls
     string name = "Timer"; // Name of the timer
 };
 
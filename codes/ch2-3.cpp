@@ -0,0 +1,314 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <optional>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+using namespace std;
+
+// Reference count lives inside the object, so there is no separate control block.
+// Atomic = false is for single-threaded object graphs: copies are a plain increment.
+template<bool Atomic>
+class RefCounted {
+public:
+    void addRef() const noexcept {
+        if constexpr (Atomic) refCount.fetch_add(1, std::memory_order_relaxed);
+        else ++refCount;
+    }
+    // returns true when the last reference is gone
+    bool release() const noexcept {
+        if constexpr (Atomic) return refCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        else return --refCount == 0;
+    }
+    int useCount() const noexcept { return refCount; }
+protected:
+    RefCounted() = default;
+    RefCounted(const RefCounted&) {} // a copy starts with its own count
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; } // and assignment keeps it
+    ~RefCounted() = default;
+private:
+    mutable std::conditional_t<Atomic, std::atomic<int>, int> refCount{0};
+};
+
+template<typename T>
+class IntrusivePtr {
+public:
+    IntrusivePtr() = default;
+    explicit IntrusivePtr(T* p) : ptr(p) { if (ptr) ptr->addRef(); }
+    IntrusivePtr(const IntrusivePtr& other) : ptr(other.ptr) { if (ptr) ptr->addRef(); }
+    IntrusivePtr(IntrusivePtr&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+    ~IntrusivePtr() { reset(); }
+
+    IntrusivePtr& operator=(IntrusivePtr other) noexcept {
+        std::swap(ptr, other.ptr);
+        return *this;
+    }
+    void reset() {
+        if (ptr && ptr->release()) delete ptr;
+        ptr = nullptr;
+    }
+    T* get() const { return ptr; }
+    T& operator*() const { return *ptr; }
+    T* operator->() const { return ptr; }
+    explicit operator bool() const { return ptr != nullptr; }
+private:
+    T* ptr = nullptr;
+};
+
+template<typename T, typename... Args>
+IntrusivePtr<T> makeIntrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+// Non-owning link that is cleared when its target is destroyed: the target keeps
+// its observers in an intrusive list and nulls them from its destructor. Checking
+// a link is a null test, the bookkeeping is paid on link/unlink and destruction.
+// Single-threaded only, like RefCounted<false>.
+struct WeakNode {
+    class WeakTrackable* target = nullptr;
+    WeakNode* prev = nullptr;
+    WeakNode* next = nullptr;
+};
+
+class WeakTrackable {
+protected:
+    WeakTrackable() = default;
+    WeakTrackable(const WeakTrackable&) {} // observers stay with the original
+    WeakTrackable& operator=(const WeakTrackable&) { return *this; }
+    ~WeakTrackable() {
+        for (WeakNode* n = observers; n;) {
+            WeakNode* next = n->next;
+            *n = WeakNode{};
+            n = next;
+        }
+    }
+private:
+    template<typename T> friend class WeakLink;
+    WeakNode* observers = nullptr;
+};
+
+template<typename T>
+class WeakLink {
+public:
+    WeakLink() = default;
+    explicit WeakLink(T* p) { attach(p); }
+    WeakLink(const WeakLink& other) { attach(other.get()); }
+    WeakLink& operator=(const WeakLink& other) {
+        if (this != &other) {
+            detach();
+            attach(other.get());
+        }
+        return *this;
+    }
+    ~WeakLink() { detach(); }
+
+    // nullptr once the target is gone
+    T* get() const { return static_cast<T*>(node.target); }
+    explicit operator bool() const { return node.target != nullptr; }
+private:
+    void attach(T* p) {
+        if (!p) return;
+        WeakTrackable* t = p;
+        node.target = t;
+        node.next = t->observers;
+        if (node.next) node.next->prev = &node;
+        t->observers = &node;
+    }
+    void detach() {
+        if (!node.target) return;
+        if (node.prev) node.prev->next = node.next;
+        else node.target->observers = node.next;
+        if (node.next) node.next->prev = node.prev;
+        node = WeakNode{};
+    }
+    WeakNode node;
+};
+
+// Generational index: a stale handle has an older generation than its slot,
+// so dangling references are detected by one compare instead of a lock().
+struct Handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+template<typename T>
+class SlotMap {
+public:
+    template<typename... Args>
+    Handle emplace(Args&&... args) {
+        uint32_t idx;
+        if (!freeList.empty()) {
+            idx = freeList.back();
+            freeList.pop_back();
+        } else {
+            idx = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        slots[idx].value.emplace(std::forward<Args>(args)...);
+        return Handle{idx, slots[idx].generation};
+    }
+    bool erase(Handle h) {
+        if (!contains(h)) return false;
+        slots[h.index].value.reset();
+        ++slots[h.index].generation; // every outstanding handle becomes stale
+        freeList.push_back(h.index);
+        return true;
+    }
+    bool contains(Handle h) const {
+        return h.index < slots.size() && slots[h.index].generation == h.generation && slots[h.index].value;
+    }
+    // nullptr for a dangling handle
+    T* get(Handle h) { return contains(h) ? &*slots[h.index].value : nullptr; }
+    const T* get(Handle h) const { return contains(h) ? &*slots[h.index].value : nullptr; }
+    size_t size() const { return slots.size() - freeList.size(); }
+private:
+    struct Slot {
+        std::optional<T> value;
+        uint32_t generation = 0;
+    };
+    vector<Slot> slots;
+    vector<uint32_t> freeList;
+};
+
+// Same User graph as ch2-2.cpp, one version per link type
+struct SharedUser {
+    int id;
+    std::weak_ptr<SharedUser> friend_link;
+    explicit SharedUser(int id) : id(id) {}
+};
+
+struct IntrusiveUser : RefCounted<false>, WeakTrackable {
+    int id;
+    WeakLink<IntrusiveUser> friend_link; // observer, the graph owner holds the IntrusivePtr
+    explicit IntrusiveUser(int id) : id(id) {}
+};
+
+struct SlotUser {
+    int id;
+    Handle friend_link;
+    explicit SlotUser(int id) : id(id) {}
+};
+
+int main() {
+    cout << "\n\nProblem 1: Dangling detection with SlotMap handles" << endl;
+    cout << "--------------------------------" << endl;
+    {
+        SlotMap<string> names;
+        Handle alice = names.emplace("Alice");
+        Handle bob = names.emplace("Bob");
+        cout << "alice -> " << *names.get(alice) << ", bob -> " << *names.get(bob) << endl;
+        names.erase(alice);
+        Handle carol = names.emplace("Carol"); // reuses Alice's slot with a new generation
+        cout << "alice is " << (names.get(alice) ? "alive" : "dangling")
+             << ", carol -> " << *names.get(carol) << " (slot " << carol.index << ")" << endl;
+    }
+
+    cout << "\n\nProblem 2: IntrusivePtr use count and WeakLink" << endl;
+    cout << "--------------------------------" << endl;
+    {
+        auto u = makeIntrusive<IntrusiveUser>(1);
+        {
+            auto copy = u;
+            cout << "use count with a copy: " << u->useCount() << endl;
+        }
+        cout << "use count after copy is gone: " << u->useCount() << endl;
+
+        auto v = makeIntrusive<IntrusiveUser>(2);
+        u->friend_link = WeakLink<IntrusiveUser>(v.get());
+        cout << "u -> friend " << u->friend_link.get()->id << endl;
+        v.reset();
+        cout << "after the friend is released, u's link is " << (u->friend_link ? "alive" : "dangling") << endl;
+    }
+
+    cout << "\n\nProblem 3: Compare copy and traversal cost against shared_ptr" << endl;
+    cout << "--------------------------------" << endl;
+    const int nUsers = 1'000'000;
+    const int nSteps = 10'000'000;
+    std::mt19937 rng(42);
+    vector<int> next(nUsers);
+    for (auto& n : next) n = rng() % nUsers;
+
+    vector<shared_ptr<SharedUser>> shared;
+    vector<IntrusivePtr<IntrusiveUser>> intrusive;
+    SlotMap<SlotUser> slots;
+    vector<Handle> handles;
+    shared.reserve(nUsers);
+    intrusive.reserve(nUsers);
+    handles.reserve(nUsers);
+    for (int i = 0; i < nUsers; ++i) {
+        shared.push_back(make_shared<SharedUser>(i));
+        intrusive.push_back(makeIntrusive<IntrusiveUser>(i));
+        handles.push_back(slots.emplace(i));
+    }
+    for (int i = 0; i < nUsers; ++i) {
+        shared[i]->friend_link = shared[next[i]];
+        intrusive[i]->friend_link = WeakLink<IntrusiveUser>(intrusive[next[i]].get());
+        slots.get(handles[i])->friend_link = handles[next[i]];
+    }
+
+    auto timeIt = [](const char* label, auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        long long checksum = body();
+        auto end = std::chrono::high_resolution_clock::now();
+        cout << label << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+             << " ms (checksum " << checksum << ")" << endl;
+    };
+
+    timeIt("copy shared_ptr:          ", [&] {
+        long long sum = 0;
+        for (int i = 0; i < nSteps; ++i) {
+            shared_ptr<SharedUser> copy = shared[i % nUsers];
+            sum += copy->id;
+        }
+        return sum;
+    });
+    timeIt("copy IntrusivePtr:        ", [&] {
+        long long sum = 0;
+        for (int i = 0; i < nSteps; ++i) {
+            IntrusivePtr<IntrusiveUser> copy = intrusive[i % nUsers];
+            sum += copy->id;
+        }
+        return sum;
+    });
+    timeIt("copy Handle:              ", [&] {
+        long long sum = 0;
+        for (int i = 0; i < nSteps; ++i) {
+            Handle copy = handles[i % nUsers];
+            sum += slots.get(copy)->id;
+        }
+        return sum;
+    });
+
+    timeIt("traverse weak_ptr::lock:  ", [&] {
+        long long sum = 0;
+        auto cur = shared[0];
+        for (int i = 0; i < nSteps; ++i) {
+            cur = cur->friend_link.lock();
+            sum += cur->id;
+        }
+        return sum;
+    });
+    timeIt("traverse WeakLink:        ", [&] {
+        long long sum = 0;
+        IntrusiveUser* cur = intrusive[0].get();
+        for (int i = 0; i < nSteps; ++i) {
+            cur = cur->friend_link.get(); // checked, null if the friend was destroyed
+            sum += cur->id;
+        }
+        return sum;
+    });
+    timeIt("traverse SlotMap handle:  ", [&] {
+        long long sum = 0;
+        const SlotUser* cur = slots.get(handles[0]);
+        for (int i = 0; i < nSteps; ++i) {
+            cur = slots.get(cur->friend_link);
+            sum += cur->id;
+        }
+        return sum;
+    });
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <span>
+using namespace std;
+
+// Owns every User in one vector, friend links are indices into it.
+// Nothing is freed on unlink; collect() marks from the roots and then
+// drops all unreachable users at once, so cycles are not a problem.
+class UserGraph {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId INVALID = UINT32_MAX;
+
+    struct User {
+        std::string name;
+    };
+
+    NodeId addUser(std::string name) {
+        nodes.push_back(User{std::move(name)});
+        adjacencyStale = true;
+        return static_cast<NodeId>(nodes.size() - 1);
+    }
+    void addFriend(NodeId from, NodeId to) {
+        check(from);
+        check(to);
+        edges.push_back({from, to});
+        adjacencyStale = true;
+    }
+    // O(edges); returns false if there was no such link
+    bool removeFriend(NodeId from, NodeId to) {
+        adjacencyStale = true;
+        return std::erase_if(edges, [&](const Edge& e) { return e.from == from && e.to == to; }) > 0;
+    }
+    void addRoot(NodeId id) {
+        check(id);
+        roots.push_back(id);
+    }
+    void removeRoot(NodeId id) { std::erase(roots, id); }
+    void clearRoots() { roots.clear(); }
+
+    const User& operator[](NodeId id) const {
+        check(id);
+        return nodes[id];
+    }
+    // view into a cached CSR adjacency, rebuilt lazily after the graph changes;
+    // valid until the next addUser/addFriend/removeFriend/collect
+    std::span<const NodeId> friendsOf(NodeId id) const {
+        check(id);
+        if (adjacencyStale) buildAdjacency();
+        return std::span<const NodeId>(adjacency).subspan(offsets[id], offsets[id + 1] - offsets[id]);
+    }
+    size_t size() const { return nodes.size(); }
+    size_t edgeCount() const { return edges.size(); }
+
+    // Mark phase from the roots, then compact survivors to the front.
+    // Returns old id -> new id (INVALID for collected users); roots are remapped in place.
+    vector<NodeId> collect() {
+        const NodeId n = static_cast<NodeId>(nodes.size());
+        if (adjacencyStale) buildAdjacency();
+
+        vector<bool> marked(n, false);
+        vector<NodeId> stack;
+        for (auto r : roots) {
+            if (!marked[r]) { marked[r] = true; stack.push_back(r); }
+        }
+        while (!stack.empty()) {
+            NodeId cur = stack.back();
+            stack.pop_back();
+            for (NodeId i = offsets[cur]; i < offsets[cur + 1]; ++i) {
+                NodeId next = adjacency[i];
+                if (!marked[next]) { marked[next] = true; stack.push_back(next); }
+            }
+        }
+
+        vector<NodeId> remap(n, INVALID);
+        NodeId alive = 0;
+        for (NodeId i = 0; i < n; ++i) {
+            if (!marked[i]) continue;
+            if (alive != i) nodes[alive] = std::move(nodes[i]);
+            remap[i] = alive++;
+        }
+        nodes.resize(alive); // batched destruction of everything unreachable
+
+        size_t keptEdges = 0;
+        for (const auto& e : edges) {
+            // an edge from a live user always points to a live user
+            if (remap[e.from] != INVALID) edges[keptEdges++] = {remap[e.from], remap[e.to]};
+        }
+        edges.resize(keptEdges);
+        for (auto& r : roots) r = remap[r];
+        adjacencyStale = true;
+        return remap;
+    }
+private:
+    // CSR from the edge list with a counting sort
+    void buildAdjacency() const {
+        const NodeId n = static_cast<NodeId>(nodes.size());
+        offsets.assign(n + 1, 0);
+        for (const auto& e : edges) ++offsets[e.from + 1];
+        for (NodeId i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+        adjacency.resize(edges.size());
+        vector<NodeId> fill(offsets.begin(), offsets.end() - 1);
+        for (const auto& e : edges) adjacency[fill[e.from]++] = e.to;
+        adjacencyStale = false;
+    }
+
+    void check(NodeId id) const {
+        if (id >= nodes.size()) throw std::out_of_range("unknown user id " + std::to_string(id));
+    }
+
+    struct Edge {
+        NodeId from;
+        NodeId to;
+    };
+    vector<User> nodes;
+    vector<Edge> edges;
+    vector<NodeId> roots;
+    mutable vector<NodeId> offsets;
+    mutable vector<NodeId> adjacency;
+    mutable bool adjacencyStale = true;
+};
+
+// shared_ptr version of the ch2-2.cpp User, counting instead of printing
+struct SharedUser {
+    static inline long long alive = 0;
+    std::string name;
+    vector<shared_ptr<SharedUser>> friends;
+    explicit SharedUser(std::string n) : name(std::move(n)) { ++alive; }
+    ~SharedUser() { --alive; }
+};
+
+int main() {
+    cout << "\n\nProblem 1: Alice and Bob friend cycle collected by UserGraph" << endl;
+    cout << "--------------------------------" << endl;
+    {
+        UserGraph graph;
+        auto alice = graph.addUser("Alice");
+        auto bob = graph.addUser("Bob");
+        auto carol = graph.addUser("Carol");
+        auto dave = graph.addUser("Dave");
+        graph.addFriend(alice, bob);
+        graph.addFriend(bob, alice); // the cycle that leaks in ch2-2.cpp
+        graph.addFriend(carol, alice);
+        graph.addFriend(dave, dave);
+        graph.addRoot(carol);
+        auto remap = graph.collect(); // ids change on compaction, translate the ones we hold
+        alice = remap[alice];
+        bob = remap[bob];
+        carol = remap[carol];
+        cout << "With Carol as root, users alive:";
+        for (UserGraph::NodeId i = 0; i < graph.size(); ++i) cout << " " << graph[i].name;
+        cout << endl;
+        cout << "Alice's friends:";
+        for (auto f : graph.friendsOf(alice)) cout << " " << graph[f].name;
+        cout << endl;
+
+        graph.removeFriend(alice, bob); // Alice unfriends Bob
+        graph.collect();
+        cout << "After Alice unfriends Bob, users alive:";
+        for (UserGraph::NodeId i = 0; i < graph.size(); ++i) cout << " " << graph[i].name;
+        cout << endl;
+
+        graph.clearRoots(); // everyone leaves scope
+        graph.collect();
+        cout << "Without roots, users alive: " << graph.size() << endl;
+    }
+
+    cout << "\n\nProblem 2: Collect a large social graph" << endl;
+    cout << "--------------------------------" << endl;
+    const int nUsers = 1'000'000;
+    const int nFriends = 4;
+    std::mt19937 rng(7);
+    // One edge list for both versions. Every user befriends earlier users, so the
+    // first half (the roots) never reaches the second half, and the second half is
+    // also chained into a ring: garbage with a cycle in it.
+    vector<std::pair<uint32_t, uint32_t>> friendships;
+    for (uint32_t i = 1; i < nUsers; ++i) {
+        for (int k = 0; k < nFriends; ++k) friendships.push_back({i, static_cast<uint32_t>(rng() % i)});
+    }
+    for (uint32_t i = nUsers / 2; i < nUsers; ++i) friendships.push_back({i, i + 1 < nUsers ? i + 1 : nUsers / 2});
+
+    // shared_ptr needs the ring broken by hand before the second half is dropped,
+    // otherwise it leaks exactly like ch2-2.cpp; UserGraph finds the garbage itself.
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        vector<shared_ptr<SharedUser>> users;
+        users.reserve(nUsers);
+        for (int i = 0; i < nUsers; ++i) {
+            users.push_back(make_shared<SharedUser>("user" + to_string(i)));
+        }
+        for (auto [from, to] : friendships) {
+            users[from]->friends.push_back(users[to]);
+        }
+        for (int i = nUsers / 2; i < nUsers; ++i) users[i]->friends.clear(); // manual unlink
+        users.resize(nUsers / 2); // drop the second half of the roots
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    cout << "shared_ptr + manual unlink: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, users alive after scope exit: " << SharedUser::alive << endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    size_t survivors;
+    {
+        UserGraph graph;
+        for (int i = 0; i < nUsers; ++i) {
+            graph.addUser("user" + to_string(i));
+        }
+        for (auto [from, to] : friendships) {
+            graph.addFriend(from, to);
+        }
+        for (int i = 0; i < nUsers / 2; ++i) {
+            graph.addRoot(i);
+        }
+        graph.collect();
+        survivors = graph.size();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    cout << "UserGraph + collect():      " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, users kept by collect(): " << survivors << ", all freed at scope exit" << endl;
+    return 0;
+}
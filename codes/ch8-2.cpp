@@ -0,0 +1,349 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <span>
+#include <ranges>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <coroutine>
+#include <chrono>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+// Generator from ch10.cpp
+template<typename T>
+struct Generator {
+    struct promise_type {
+        T value;
+        auto get_return_object() { return Generator{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        auto initial_suspend() { return std::suspend_always{}; }
+        auto final_suspend() noexcept { return std::suspend_always{}; }
+        void unhandled_exception() { std::terminate(); }
+        auto yield_value(T val) { value = val; return std::suspend_always{}; }
+    };
+    using handle_type = std::coroutine_handle<promise_type>;
+    Generator(handle_type h) : handle(h) {}
+    Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    ~Generator() { if (handle) handle.destroy(); }
+    T value() const { return handle.promise().value; }
+    bool next() { handle.resume(); return !handle.done(); }
+    handle_type handle;
+};
+
+namespace chunked {
+
+// Sources. A random access source hands out [begin, end) slices directly;
+// a stream source is pulled sequentially into chunk buffers.
+template<typename T>
+struct SpanSource {
+    static constexpr bool randomAccess = true;
+    using value_type = T;
+    std::span<const T> data;
+    size_t size() const { return data.size(); }
+};
+
+template<typename T>
+struct GeneratorSource {
+    static constexpr bool randomAccess = false;
+    using value_type = T;
+    Generator<T> gen;
+    bool done = false; // resuming a finished coroutine is undefined
+    size_t pull(vector<T>& out, size_t n) {
+        out.clear();
+        while (out.size() < n && !done) {
+            if (gen.next()) out.push_back(gen.value());
+            else done = true;
+        }
+        return out.size();
+    }
+};
+
+template<typename T>
+struct StreamSource {
+    static constexpr bool randomAccess = false;
+    using value_type = T;
+    std::istream* in;
+    size_t pull(vector<T>& out, size_t n) {
+        out.clear();
+        T v;
+        while (out.size() < n && (*in >> v)) out.push_back(v);
+        return out.size();
+    }
+};
+
+// Reducers: an empty State, add one value, merge another State in.
+template<typename T>
+struct Sum {
+    using State = std::conditional_t<std::is_integral_v<T>, long long, double>;
+    State init() const { return 0; }
+    void add(State& s, const T& v) const { s += v; }
+    void merge(State& s, State&& o) const { s += o; }
+    State finish(State s) const { return s; }
+};
+
+template<typename T>
+struct Count {
+    using State = size_t;
+    State init() const { return 0; }
+    void add(State& s, const T&) const { ++s; }
+    void merge(State& s, State&& o) const { s += o; }
+    State finish(State s) const { return s; }
+};
+
+// k largest values, a bounded min-heap per chunk
+template<typename T>
+struct TopK {
+    size_t k;
+    using State = vector<T>;
+    State init() const { return {}; }
+    void add(State& s, const T& v) const {
+        if (k == 0) return;
+        if (s.size() < k) {
+            s.push_back(v);
+            std::push_heap(s.begin(), s.end(), std::greater<>{});
+        } else if (v > s.front()) {
+            std::pop_heap(s.begin(), s.end(), std::greater<>{});
+            s.back() = v;
+            std::push_heap(s.begin(), s.end(), std::greater<>{});
+        }
+    }
+    void merge(State& s, State&& o) const { for (const auto& v : o) add(s, v); }
+    State finish(State s) const {
+        std::sort(s.begin(), s.end(), std::greater<>{});
+        return s;
+    }
+};
+
+template<typename T>
+struct Collect {
+    using State = vector<T>;
+    State init() const { return {}; }
+    void add(State& s, const T& v) const { s.push_back(v); }
+    void merge(State& s, State&& o) const { s.insert(s.end(), o.begin(), o.end()); }
+    State finish(State s) const { return s; }
+};
+
+// Push-based pipeline: every filter/transform is fused into one Stage callable,
+// Stage(x, emit) calls emit for each value that comes out the other end.
+// Evaluation walks the source chunk by chunk; with threads > 1 the workers grab
+// chunks from an atomic counter and the per-chunk results are merged at the end.
+template<typename Source, typename Stage, typename T>
+class Pipeline {
+public:
+    using value_type = T;
+
+    Pipeline(Source src, Stage stage) : src(std::move(src)), stage(std::move(stage)) {}
+
+    template<typename Pred>
+    auto filter(Pred pred) && {
+        auto next = [prev = std::move(stage), pred](const auto& x, auto&& emit) {
+            prev(x, [&](const T& y) { if (pred(y)) emit(y); });
+        };
+        return rebind<T>(std::move(next));
+    }
+    template<typename Func>
+    auto transform(Func func) && {
+        using U = std::decay_t<std::invoke_result_t<Func, const T&>>;
+        auto next = [prev = std::move(stage), func](const auto& x, auto&& emit) {
+            prev(x, [&](const T& y) { emit(func(y)); });
+        };
+        return rebind<U>(std::move(next));
+    }
+
+    Pipeline&& threads(int n) && { nThreads = std::max(1, n); return std::move(*this); }
+    Pipeline&& chunk(size_t n) && { chunkSize = std::max<size_t>(1, n); return std::move(*this); }
+    // results may be merged in completion order; only matters for collect()
+    Pipeline&& unordered() && { ordered = false; return std::move(*this); }
+
+    auto sum() && { return std::move(*this).reduce(Sum<T>{}); }
+    size_t count() && { return std::move(*this).reduce(Count<T>{}); }
+    vector<T> topK(size_t k) && { return std::move(*this).reduce(TopK<T>{k}); }
+    vector<T> collect() && { return std::move(*this).reduce(Collect<T>{}); }
+
+    template<typename Reducer>
+    auto reduce(Reducer r) && {
+        if constexpr (Source::randomAccess) return reduceSpan(r);
+        else return reduceStream(r);
+    }
+private:
+    template<typename S, typename St, typename U>
+    friend class Pipeline;
+
+    template<typename U, typename NewStage>
+    Pipeline<Source, NewStage, U> rebind(NewStage next) {
+        Pipeline<Source, NewStage, U> p(std::move(src), std::move(next));
+        p.nThreads = nThreads;
+        p.chunkSize = chunkSize;
+        p.ordered = ordered;
+        return p;
+    }
+
+    template<typename Reducer, typename Input>
+    void runChunk(const Reducer& r, typename Reducer::State& state, const Input* first, const Input* last) const {
+        for (; first != last; ++first) {
+            stage(*first, [&](const T& v) { r.add(state, v); });
+        }
+    }
+
+    template<typename Reducer>
+    auto reduceSpan(const Reducer& r) const {
+        using State = typename Reducer::State;
+        const auto data = src.data;
+        const size_t nChunks = (data.size() + chunkSize - 1) / chunkSize;
+        auto chunkRange = [&](size_t c) {
+            const auto* first = data.data() + c * chunkSize;
+            return std::pair{first, first + std::min(chunkSize, data.size() - c * chunkSize)};
+        };
+        State result = r.init();
+        if (nThreads == 1) {
+            for (size_t c = 0; c < nChunks; ++c) {
+                auto [first, last] = chunkRange(c);
+                runChunk(r, result, first, last);
+            }
+            return r.finish(std::move(result));
+        }
+
+        std::atomic<size_t> nextChunk{0};
+        vector<State> perChunk; // ordered: one state per chunk, merged in chunk order
+        if (ordered) perChunk.resize(nChunks, r.init());
+        vector<future<State>> workers;
+        for (int t = 0; t < nThreads; ++t) {
+            workers.push_back(async(launch::async, [&] {
+                State local = r.init();
+                for (size_t c = nextChunk++; c < nChunks; c = nextChunk++) {
+                    auto [first, last] = chunkRange(c);
+                    runChunk(r, ordered ? perChunk[c] : local, first, last);
+                }
+                return local;
+            }));
+        }
+        for (auto& w : workers) r.merge(result, w.get());
+        for (auto& s : perChunk) r.merge(result, std::move(s));
+        return r.finish(std::move(result));
+    }
+
+    // Pull nThreads chunks at a time, run them in parallel, merge in order.
+    template<typename Reducer>
+    auto reduceStream(const Reducer& r) {
+        using State = typename Reducer::State;
+        using Input = typename Source::value_type;
+        State result = r.init();
+        vector<vector<Input>> buffers(nThreads);
+        while (true) {
+            int filled = 0;
+            while (filled < nThreads && src.pull(buffers[filled], chunkSize) > 0) ++filled;
+            if (filled == 0) break;
+            vector<future<State>> workers;
+            for (int t = 0; t < filled; ++t) {
+                workers.push_back(async(filled == 1 ? launch::deferred : launch::async, [&, t] {
+                    State local = r.init();
+                    runChunk(r, local, buffers[t].data(), buffers[t].data() + buffers[t].size());
+                    return local;
+                }));
+            }
+            for (auto& w : workers) r.merge(result, w.get());
+            if (filled < nThreads) break;
+        }
+        return r.finish(std::move(result));
+    }
+
+    Source src;
+    Stage stage;
+    int nThreads = 1;
+    size_t chunkSize = 16 * 1024; // 64KB of int, stays in L2
+    bool ordered = true;
+};
+
+inline constexpr auto identity = [](const auto& x, auto&& emit) { emit(x); };
+
+// the pipeline only views the vector, so it must outlive the pipeline
+template<typename T>
+auto from(const vector<T>& v) {
+    return Pipeline<SpanSource<T>, decltype(identity), T>(SpanSource<T>{v}, identity);
+}
+template<typename T>
+auto from(vector<T>&&) = delete; // a temporary would be gone before the first chunk is read
+template<typename T>
+auto from(const vector<T>&&) = delete;
+template<typename T>
+auto from(Generator<T> gen) {
+    return Pipeline<GeneratorSource<T>, decltype(identity), T>(GeneratorSource<T>{std::move(gen)}, identity);
+}
+template<typename T>
+auto from(std::istream& in) {
+    return Pipeline<StreamSource<T>, decltype(identity), T>(StreamSource<T>{&in}, identity);
+}
+
+// adaptors so the ch8 "| views::filter(...) | views::transform(...)" spelling works
+template<typename Pred> struct FilterAdaptor { Pred pred; };
+template<typename Func> struct TransformAdaptor { Func func; };
+template<typename Pred> FilterAdaptor<Pred> filter(Pred pred) { return {std::move(pred)}; }
+template<typename Func> TransformAdaptor<Func> transform(Func func) { return {std::move(func)}; }
+
+template<typename Src, typename St, typename T, typename Pred>
+auto operator|(Pipeline<Src, St, T>&& p, FilterAdaptor<Pred> a) { return std::move(p).filter(std::move(a.pred)); }
+template<typename Src, typename St, typename T, typename Func>
+auto operator|(Pipeline<Src, St, T>&& p, TransformAdaptor<Func> a) { return std::move(p).transform(std::move(a.func)); }
+
+} // namespace chunked
+
+Generator<int> naturals(int n) {
+    for (int i = 1; i <= n; ++i) {
+        co_yield i;
+    }
+}
+
+int main() {
+    cout << "\n\nProblem 1: ch8 filter/transform pipeline, chunked" << endl;
+    vector<int> nums = {1, 2, 3, 4, 5, 6};
+    auto squares = (chunked::from(nums)
+        | chunked::filter([](int n) { return n % 2 == 0; })
+        | chunked::transform([](int n) { return n * n; })).collect();
+    for (int x : squares) {
+        cout << x << " ";
+    }
+    cout << endl;
+
+    cout << "\n\nProblem 2: Stream sources (Generator and istream)" << endl;
+    auto evenSum = (chunked::from(naturals(100)) | chunked::filter([](int n) { return n % 2 == 0; })).threads(4).sum();
+    cout << "Sum of even numbers 1..100 from a Generator: " << evenSum << endl;
+    std::istringstream file("5 17 3 42 8 99 23 1 64");
+    auto top3 = chunked::from<int>(file).topK(3);
+    cout << "Top 3 values from a stream: ";
+    for (int x : top3) cout << x << " ";
+    cout << endl;
+
+    cout << "\n\nProblem 3: 200 million rows, views vs chunked parallel" << endl;
+    vector<int> rows(200'000'000);
+    std::iota(rows.begin(), rows.end(), 0);
+    auto isKept = [](int n) { return n % 3 == 0; };
+    auto scale = [](int n) { return static_cast<long long>(n) * 2; };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    long long viewsSum = 0;
+    for (auto x : rows | views::filter(isKept) | views::transform(scale)) viewsSum += x;
+    auto end = std::chrono::high_resolution_clock::now();
+    cout << "views, 1 thread:    " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms, sum " << viewsSum << endl;
+
+    for (int nThreads : {1, 2, 4, 8}) {
+        start = std::chrono::high_resolution_clock::now();
+        auto chunkedSum = (chunked::from(rows) | chunked::filter(isKept) | chunked::transform(scale))
+            .threads(nThreads).unordered().sum();
+        end = std::chrono::high_resolution_clock::now();
+        cout << "chunked, " << nThreads << " threads: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+             << " ms, sum " << chunkedSum << endl;
+    }
+
+    auto top = (chunked::from(rows) | chunked::transform([](int n) { return static_cast<unsigned>(n) * 2654435761u; }))
+        .threads(8).topK(5);
+    cout << "Top 5 hashed rows: ";
+    for (auto x : top) cout << x << " ";
+    cout << endl;
+    return 0;
+}
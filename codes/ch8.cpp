@@ -6,6 +6,11 @@
 #include <string>
 #include <chrono>  // For std::chrono
 #include <ranges>  // For ranges and views
+#include <span>    // For std::span
+#include <cstdint>
+#include <bit>     // For std::popcount
+#include <utility> // For std::index_sequence
+#include <algorithm>
 using namespace std;
 
 std::optional<int> parseId(const int& value) {
@@ -23,14 +28,104 @@ void printId(const std::optional<int>& id) {
     }
 }
 
+void printValue(int value) {
+    std::cout << "Value (int): " << value << std::endl; // Print the integer value
+}
+
+void printValue(const std::string& value) {
+    std::cout << "Value (string): " << value << std::endl; // Print the string value
+}
+
 void printValue(std::variant<int, std::string> value) {
-    if (std::holds_alternative<int>(value)) {
-        std::cout << "Value (int): " << std::get<int>(value) << std::endl; // Print the integer value
-    } else {
-        std::cout << "Value (string): " << std::get<std::string>(value) << std::endl; // Print the string value
-    }
+    std::visit([](const auto& v) { printValue(v); }, value);
 }
 
+// Column of optional<T> without the per-element flag and padding:
+// values are stored densely, presence is one bit per row.
+template<typename T>
+class NullableColumn {
+public:
+    void push_back(const std::optional<T>& v) {
+        if (values.size() % 64 == 0) validity.push_back(0);
+        if (v) validity.back() |= uint64_t(1) << (values.size() % 64);
+        values.push_back(v.value_or(T{}));
+    }
+    std::optional<T> operator[](size_t i) const {
+        if (validity[i / 64] >> (i % 64) & 1) return values[i];
+        return std::nullopt;
+    }
+    size_t size() const { return values.size(); }
+    size_t countValid() const {
+        size_t cnt = 0;
+        for (auto word : validity) cnt += std::popcount(word);
+        return cnt;
+    }
+    // onValue(row, value) / onNull(row); a fully valid block of 64 rows skips the bit tests
+    template<typename OnValue, typename OnNull>
+    void visit(OnValue onValue, OnNull onNull) const {
+        for (size_t w = 0; w < validity.size(); ++w) {
+            size_t begin = w * 64, end = std::min(begin + 64, values.size());
+            if (validity[w] == ~uint64_t(0)) {
+                for (size_t i = begin; i < end; ++i) onValue(i, values[i]);
+                continue;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                if (validity[w] >> (i - begin) & 1) onValue(i, values[i]);
+                else onNull(i);
+            }
+        }
+    }
+private:
+    vector<T> values;
+    vector<uint64_t> validity;
+};
+
+// Column of variant<Ts...>: one tag byte per row and a dense array per alternative.
+// visitRuns() switches on the tag once per run of equal tags and hands over a span.
+template<typename... Ts>
+class TaggedColumn {
+public:
+    template<typename T>
+    void push_back(T v) {
+        constexpr uint8_t tag = tagOf<std::decay_t<T>>();
+        tags.push_back(tag);
+        std::get<tag>(values).push_back(std::move(v));
+    }
+    void push_back(const std::variant<Ts...>& v) {
+        std::visit([this](const auto& x) { push_back(x); }, v);
+    }
+    size_t size() const { return tags.size(); }
+
+    // func(firstRow, span<const T>) for every run of rows holding the same alternative
+    template<typename Func>
+    void visitRuns(Func&& func) const {
+        visitRunsImpl(func, std::index_sequence_for<Ts...>{});
+    }
+private:
+    template<typename T>
+    static constexpr uint8_t tagOf() {
+        constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+        for (uint8_t i = 0; i < sizeof...(Ts); ++i) {
+            if (matches[i]) return i;
+        }
+        return sizeof...(Ts);
+    }
+    template<typename Func, size_t... Is>
+    void visitRunsImpl(Func& func, std::index_sequence<Is...>) const {
+        size_t cursor[sizeof...(Ts)] = {};
+        for (size_t i = 0; i < tags.size();) {
+            const uint8_t tag = tags[i];
+            size_t j = i + 1;
+            while (j < tags.size() && tags[j] == tag) ++j;
+            ((tag == Is ? (func(i, std::span(std::get<Is>(values)).subspan(cursor[Is], j - i)), true) : false) || ...);
+            cursor[tag] += j - i;
+            i = j;
+        }
+    }
+    vector<uint8_t> tags;
+    std::tuple<vector<Ts>...> values;
+};
+
 template<typename T>
 inline void printConstExpr(T val) {
     if constexpr (std::is_integral_v<T>) {
@@ -52,10 +147,26 @@ int main () {
     id = parseId(value); // Call the function again with a negative value
     printId(id); // Print the ID, which should indicate no value provided
 
+    NullableColumn<int> ids; // a whole column of parsed IDs, one validity bit each
+    for (int raw : {7, -3, 19, 23, -8}) {
+        ids.push_back(parseId(raw));
+    }
+    ids.visit([](size_t, int v) { printId(v); }, [](size_t) { printId(std::nullopt); });
+    cout << ids.countValid() << " of " << ids.size() << " IDs are valid" << endl;
+
     cout << "\n\nProblem 8-2: Using std::variant for value handling\n";
     printValue(42); // Call the function with an integer value
     printValue(std::string("Hello, World!")); // Call the function with a string value
 
+    TaggedColumn<int, std::string> values; // tag byte per row, values stored by type
+    values.push_back(1);
+    values.push_back(2);
+    values.push_back(std::string("three"));
+    values.push_back(std::variant<int, std::string>(4));
+    values.visitRuns([](size_t, auto run) {
+        for (const auto& v : run) printValue(v); // one tag check per run, not per value
+    });
+
 
     cout << "\n\nProblem 8-3: Using std::tuple for structured binding\n";
     std::tuple<int, double, std::string> myTuple(1, 3.14, "example");
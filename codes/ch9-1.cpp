@@ -10,10 +10,85 @@
 #include <variant>
 #include <cstdlib>
 #include <iomanip>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <array>
+#include <limits>
+#include <ranges>
+#include <iterator>
+#include <type_traits>
+#include <bit>
+#include <cmath>
 using namespace std;
 
+// Column of variant<Ts...>: one tag byte per row and a dense array per alternative,
+// so a result column has no per-row padding. visitRuns() switches on the tag once
+// per run of equal tags (same as the TaggedColumn in ch8.cpp).
+template<typename... Ts>
+class TaggedColumn {
+public:
+    template<typename T>
+    void push_back(T v) {
+        constexpr uint8_t tag = tagOf<std::decay_t<T>>();
+        tags.push_back(tag);
+        std::get<tag>(values).push_back(std::move(v));
+    }
+    void push_back(const std::variant<Ts...>& v) {
+        std::visit([this](const auto& x) { push_back(x); }, v);
+    }
+    size_t size() const { return tags.size(); }
 
-class statistics {
+    // func(firstRow, span<const T>) for every run of rows holding the same alternative
+    template<typename Func>
+    void visitRuns(Func&& func) const {
+        visitRunsImpl(func, std::index_sequence_for<Ts...>{});
+    }
+private:
+    template<typename T>
+    static constexpr uint8_t tagOf() {
+        constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+        for (uint8_t i = 0; i < sizeof...(Ts); ++i) {
+            if (matches[i]) return i;
+        }
+        return sizeof...(Ts);
+    }
+    template<typename Func, size_t... Is>
+    void visitRunsImpl(Func& func, std::index_sequence<Is...>) const {
+        size_t cursor[sizeof...(Ts)] = {};
+        for (size_t i = 0; i < tags.size();) {
+            const uint8_t tag = tags[i];
+            size_t j = i + 1;
+            while (j < tags.size() && tags[j] == tag) ++j;
+            ((tag == Is ? (func(i, std::span(std::get<Is>(values)).subspan(cursor[Is], j - i)), true) : false) || ...);
+            cursor[tag] += j - i;
+            i = j;
+        }
+    }
+    vector<uint8_t> tags;
+    std::tuple<vector<Ts>...> values;
+};
+
+
+// same concept as ch15.cpp
+template<typename T>
+concept Iterable = requires(T t) {
+    { begin(t) } -> std::input_iterator;
+    { end(t) } -> std::input_iterator;
+};
+
+template<typename R>
+concept NumericRange = Iterable<R> && std::ranges::random_access_range<R>
+    && std::is_arithmetic_v<std::ranges::range_value_t<R>>;
+
+// statistics<> is the runtime, type-erased engine; statistics<Policies...> fuses
+// the listed reducers into one kernel at compile time (defined further below).
+template<typename... Policies>
+class statistics;
+
+template<>
+class statistics<> {
     public: 
     // constructor
     statistics(int nThread = 8) : nThread(nThread) {}
@@ -66,17 +141,299 @@ class statistics {
     int nThread; // number of threads to use
 };
 
+// Reducer policies for statistics<Policies...>. Each one provides
+// Reducer<T> with add(x) for one element, merge(other) for another chunk and value().
+struct Sum {
+    template<typename T>
+    struct Reducer {
+        using Acc = std::conditional_t<std::is_integral_v<T>, long long, double>;
+        Acc acc = 0;
+        void add(T x) { acc += x; }
+        void merge(const Reducer& o) { acc += o.acc; }
+        Acc value() const { return acc; }
+    };
+};
+
+struct Count {
+    template<typename T>
+    struct Reducer {
+        size_t n = 0;
+        void add(T) { ++n; }
+        void merge(const Reducer& o) { n += o.n; }
+        size_t value() const { return n; }
+    };
+};
+
+struct Min {
+    template<typename T>
+    struct Reducer {
+        T m = std::numeric_limits<T>::max();
+        void add(T x) { m = x < m ? x : m; }
+        void merge(const Reducer& o) { add(o.m); }
+        T value() const { return m; }
+    };
+};
+
+struct Max {
+    template<typename T>
+    struct Reducer {
+        T m = std::numeric_limits<T>::lowest();
+        void add(T x) { m = x > m ? x : m; }
+        void merge(const Reducer& o) { add(o.m); }
+        T value() const { return m; }
+    };
+};
+
+// Pred is a stateless function object type, e.g. CountIf<IsEven>
+template<typename Pred>
+struct CountIf {
+    template<typename T>
+    struct Reducer {
+        size_t n = 0;
+        void add(T x) { n += Pred{}(x) ? 1 : 0; }
+        void merge(const Reducer& o) { n += o.n; }
+        size_t value() const { return n; }
+    };
+};
+
+// Bins equal-width bins over [Lo, Hi); values outside are clamped into the edge bins
+template<size_t Bins, auto Lo, auto Hi>
+struct Histogram {
+    static_assert(Bins > 0 && Lo < Hi);
+    template<typename T>
+    struct Reducer {
+        std::array<size_t, Bins> counts{};
+        void add(T x) {
+            double pos = (static_cast<double>(x) - Lo) * Bins / (static_cast<double>(Hi) - Lo);
+            size_t bin = pos <= 0 ? 0 : std::min(static_cast<size_t>(pos), Bins - 1);
+            ++counts[bin];
+        }
+        void merge(const Reducer& o) {
+            for (size_t i = 0; i < Bins; ++i) counts[i] += o.counts[i];
+        }
+        const std::array<size_t, Bins>& value() const { return counts; }
+    };
+};
+
+// Log-bucket histogram for non-negative values (latencies, sizes, counts).
+// Each power of two is split into 2^SubBits buckets, so a bucket's width is at
+// most 1/2^SubBits of its value. Memory: (65 - SubBits) * 2^SubBits counters,
+// 61 * 16 * 8 bytes = 7.6KB for the default SubBits = 4, whatever the input size.
+template<unsigned SubBits = 4>
+class LogHistogram {
+    public:
+    static constexpr size_t nBuckets = size_t(65 - SubBits) << SubBits;
+
+    template<typename T>
+    void add(T x) { ++counts[bucketOf(x <= 0 ? 0 : static_cast<uint64_t>(x))]; }
+    void merge(const LogHistogram& o) {
+        for (size_t i = 0; i < nBuckets; ++i) counts[i] += o.counts[i];
+        total += o.total;
+    }
+    size_t count() const { return total; }
+    // lower edge of the bucket holding the q-th quantile
+    uint64_t quantile(double q) const {
+        size_t target = static_cast<size_t>(q * total);
+        size_t seen = 0;
+        for (size_t i = 0; i < nBuckets; ++i) {
+            seen += counts[i];
+            if (seen > target) return lowerBound(i);
+        }
+        return lowerBound(nBuckets - 1);
+    }
+    const std::array<size_t, nBuckets>& buckets() const { return counts; }
+    static uint64_t lowerBound(size_t i) {
+        if (i < (size_t(1) << SubBits)) return i;
+        size_t e = (i >> SubBits) + SubBits - 1;
+        uint64_t mantissa = i & ((size_t(1) << SubBits) - 1);
+        return (uint64_t(1) << e) | (mantissa << (e - SubBits));
+    }
+    private:
+    size_t bucketOf(uint64_t v) {
+        ++total;
+        if (v < (uint64_t(1) << SubBits)) return v;
+        unsigned e = std::bit_width(v) - 1;
+        uint64_t mantissa = (v >> (e - SubBits)) & ((uint64_t(1) << SubBits) - 1);
+        return (size_t(e - SubBits + 1) << SubBits) + mantissa;
+    }
+    std::array<size_t, nBuckets> counts{};
+    size_t total = 0;
+};
+
+// KLL quantile sketch. Level h holds items of weight 2^h; when a level is over its
+// capacity it is sorted and every other item (random offset) is promoted to h + 1.
+// Capacities shrink by 2/3 per level below the top (never under 8), so at most
+// 3K + 8 * levels items are retained: about 4KB for K = 256 and int, and levels
+// only grows with log2(n / K).
+// Rank error is roughly 1.7 / K (under 1% for K = 256); two sketches merge level by level.
+template<typename T, size_t K = 256>
+class KllSketch {
+    public:
+    void add(T x) {
+        if (levels.empty()) grow();
+        levels[0].push_back(x);
+        ++n;
+        if (++size >= totalCapacity) compress();
+    }
+    void merge(const KllSketch& o) {
+        while (levels.size() < o.levels.size()) grow();
+        for (size_t h = 0; h < o.levels.size(); ++h) {
+            levels[h].insert(levels[h].end(), o.levels[h].begin(), o.levels[h].end());
+        }
+        n += o.n;
+        size += o.size;
+        while (size >= totalCapacity) compress();
+    }
+    size_t count() const { return n; }
+    size_t retained() const { return size; }
+    T quantile(double q) const {
+        vector<std::pair<T, uint64_t>> weighted;
+        weighted.reserve(size);
+        for (size_t h = 0; h < levels.size(); ++h) {
+            for (auto x : levels[h]) weighted.push_back({x, uint64_t(1) << h});
+        }
+        if (weighted.empty()) return T{};
+        std::sort(weighted.begin(), weighted.end());
+        uint64_t totalWeight = 0;
+        for (const auto& w : weighted) totalWeight += w.second;
+        const double target = q * totalWeight;
+        uint64_t seen = 0;
+        for (const auto& [x, w] : weighted) {
+            seen += w;
+            if (seen > target) return x;
+        }
+        return weighted.back().first;
+    }
+    private:
+    // add a top level; every level below loses a factor 2/3 of capacity
+    void grow() {
+        levels.emplace_back();
+        capacities.resize(levels.size());
+        totalCapacity = 0;
+        for (size_t h = 0; h < levels.size(); ++h) {
+            size_t depth = levels.size() - 1 - h;
+            capacities[h] = std::max<size_t>(8, static_cast<size_t>(K * std::pow(2.0 / 3.0, depth)));
+            totalCapacity += capacities[h];
+        }
+    }
+    // compact the lowest level that is over capacity, only when the sketch as a whole is full
+    void compress() {
+        for (size_t h = 0; h < levels.size(); ++h) {
+            if (levels[h].size() < capacities[h]) continue;
+            if (h + 1 == levels.size()) grow();
+            auto& level = levels[h];
+            std::sort(level.begin(), level.end());
+            rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+            size_t offset = rng & 1;
+            size_t paired = level.size() - level.size() % 2; // an odd item out stays behind
+            for (size_t i = offset; i < paired; i += 2) {
+                levels[h + 1].push_back(level[i]);
+            }
+            level.erase(level.begin(), level.begin() + paired);
+            size -= paired / 2;
+            return;
+        }
+    }
+    vector<vector<T>> levels;
+    vector<size_t> capacities;
+    size_t totalCapacity = 0;
+    size_t size = 0; // retained items
+    size_t n = 0;    // items seen
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+};
+
+// Sketch policies: same one-pass kernel, each chunk builds its own sketch and the
+// per-thread sketches are merged at the end.
+template<size_t K = 256>
+struct Quantiles {
+    template<typename T>
+    struct Reducer {
+        KllSketch<T, K> sketch;
+        void add(T x) { sketch.add(x); }
+        void merge(const Reducer& o) { sketch.merge(o.sketch); }
+        const KllSketch<T, K>& value() const { return sketch; }
+    };
+};
+
+template<unsigned SubBits = 4>
+struct LogBuckets {
+    template<typename T>
+    struct Reducer {
+        LogHistogram<SubBits> hist;
+        void add(T x) { hist.add(x); }
+        void merge(const Reducer& o) { hist.merge(o.hist); }
+        const LogHistogram<SubBits>& value() const { return hist; }
+    };
+};
+
+struct IsEven {
+    template<typename T>
+    bool operator()(T x) const { return static_cast<long long>(x) % 2 == 0; }
+};
+
+template<typename First, typename... Rest>
+class statistics<First, Rest...> {
+    public:
+    statistics(int nThread = 8) : nThread(nThread) {}
+
+    template<typename T>
+    class Result {
+        public:
+        template<typename P>
+        decltype(auto) get() const {
+            return std::get<typename P::template Reducer<T>>(reducers).value();
+        }
+        std::tuple<typename First::template Reducer<T>, typename Rest::template Reducer<T>...> reducers;
+    };
+
+    // One pass per chunk feeds every element to every reducer; the policy list is
+    // known at compile time so the whole loop body inlines into one kernel.
+    // Chunks are index ranges into v, nothing is copied unlike statistics<>::calc.
+    template<NumericRange R>
+    auto run(const R& v) const {
+        using T = std::ranges::range_value_t<R>;
+        const size_t n = std::ranges::size(v);
+        vector<future<Result<T>>> futures;
+        futures.reserve(nThread);
+        for (int i = 0; i < nThread; ++i) {
+            auto first = std::ranges::begin(v) + i * n / nThread;
+            auto last = std::ranges::begin(v) + (i + 1) * n / nThread;
+            futures.emplace_back(async(launch::async, [first, last] {
+                Result<T> partial;
+                std::apply([first, last](auto&... r) {
+                    for (auto it = first; it != last; ++it) {
+                        const T x = *it;
+                        (r.add(x), ...);
+                    }
+                }, partial.reducers);
+                return partial;
+            }));
+        }
+        Result<T> total;
+        for (auto& fut : futures) {
+            Result<T> partial = fut.get();
+            std::apply([&partial](auto&... r) {
+                (r.merge(std::get<std::decay_t<decltype(r)>>(partial.reducers)), ...);
+            }, total.reducers);
+        }
+        return total;
+    }
+    private:
+    int nThread; // number of threads to use
+};
+
 int main () {
     cout << "Experimenting with multithreading in C++ for mean, min, max, and nEven calculations." << endl;
     // random number generation for 100000000 values
     std::vector<int> v(100'000'000);
     std::generate(v.begin(), v.end(), std::rand);
     vector<int> theardCnts = {1, 2, 4, 8};
-    cout << setw(10) << "Threads"
-        << setw(20) << "Result" 
-        << setw(20) << "Time (ms)" << endl;
+    // report columns, one row per (thread count, statistic)
+    vector<int> threadColumn;
+    TaggedColumn<double, int> resultColumn;
+    vector<long long> timeColumn;
     for(auto nThread : theardCnts) {
-        statistics stats(nThread);
+        statistics<> stats(nThread);
         vector<function<variant<double, int>()>> funcs = { 
                 [&stats, &v]() { return stats.mean(v); },
                 [&stats, &v]() { return stats.min(v); },
@@ -89,14 +446,58 @@ int main () {
             auto result = func();
             auto end = chrono::high_resolution_clock::now();
             auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
-            cout << setw(10) << nThread;
-            if(std::holds_alternative<double>(result)) {
-                cout << setw(20) << fixed << get<double>(result); 
-            } else if(std::holds_alternative<int>(result)) {
-                cout << setw(20) << fixed << get<int>(result);
-            }
-            cout << setw(20) << duration.count() << endl;
+            threadColumn.push_back(nThread);
+            resultColumn.push_back(result);
+            timeColumn.push_back(duration.count());
+        }
+    }
+
+    cout << setw(10) << "Threads"
+        << setw(20) << "Result" 
+        << setw(20) << "Time (ms)" << endl;
+    resultColumn.visitRuns([&](size_t firstRow, auto run) {
+        for (size_t k = 0; k < run.size(); ++k) {
+            cout << setw(10) << threadColumn[firstRow + k]
+                << setw(20) << fixed << run[k]
+                << setw(20) << timeColumn[firstRow + k] << endl;
         }
+    });
+
+    cout << "\nFused statistics<Sum, Count, Min, Max, CountIf<IsEven>> in one pass" << endl;
+    cout << setw(10) << "Threads" << setw(20) << "Mean" << setw(20) << "Time (ms)" << endl;
+    for(auto nThread : theardCnts) {
+        statistics<Sum, Count, Min, Max, CountIf<IsEven>> fused(nThread);
+        auto start = chrono::high_resolution_clock::now();
+        auto r = fused.run(v);
+        auto end = chrono::high_resolution_clock::now();
+        auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+        double mean = static_cast<double>(r.get<Sum>()) / r.get<Count>();
+        cout << setw(10) << nThread << setw(20) << fixed << mean << setw(20) << duration.count()
+            << "  (min " << r.get<Min>() << ", max " << r.get<Max>() << ", nEven " << r.get<CountIf<IsEven>>() << ")" << endl;
+    }
+
+    // any arithmetic element type works, here a histogram over doubles in [0, 1)
+    vector<double> ratios(v.size() / 10);
+    std::transform(v.begin(), v.begin() + ratios.size(), ratios.begin(), [](int x) { return x / (RAND_MAX + 1.0); });
+    auto hist = statistics<Histogram<4, 0, 1>, Max>(4).run(ratios);
+    cout << "Histogram of " << ratios.size() << " ratios (max " << hist.get<Max>() << "):";
+    for (auto c : hist.get<Histogram<4, 0, 1>>()) cout << " " << c;
+    cout << endl;
+
+    cout << "\nQuantile sketches merged across threads, compared with exact nth_element" << endl;
+    auto start = chrono::high_resolution_clock::now();
+    auto sketches = statistics<Quantiles<>, LogBuckets<>>(8).run(v);
+    auto end = chrono::high_resolution_clock::now();
+    cout << "Sketch pass: " << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms, KLL keeps "
+        << sketches.get<Quantiles<>>().retained() << " of " << sketches.get<Quantiles<>>().count() << " values" << endl;
+    vector<int> sorted = v;
+    cout << setw(10) << "Quantile" << setw(20) << "Exact" << setw(20) << "KLL" << setw(20) << "Log bucket" << endl;
+    for (double q : {0.5, 0.95, 0.99}) {
+        auto nth = sorted.begin() + static_cast<size_t>(q * (sorted.size() - 1));
+        std::nth_element(sorted.begin(), nth, sorted.end());
+        cout << setw(10) << setprecision(2) << q << setw(20) << *nth
+            << setw(20) << sketches.get<Quantiles<>>().quantile(q)
+            << setw(20) << sketches.get<LogBuckets<>>().quantile(q) << endl;
     }
     return 0;
 }
\ No newline at end of file
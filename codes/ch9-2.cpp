@@ -0,0 +1,351 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <tuple>
+#include <span>
+#include <future>
+#include <thread>
+#include <algorithm>
+#include <ranges>
+#include <random>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+using namespace std;
+
+// Generational id, the Handle scheme from ch2-3.cpp: a destroyed entity's index is
+// reused with a bumped generation, so a stale id is rejected instead of resolving
+// to whichever entity took the slot.
+struct Entity {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+// Access<Cs...> lists the components a system touches; const C means read-only.
+template<typename... Cs>
+struct Access {};
+
+template<typename Acc, typename F>
+struct System {
+    using AccessType = Acc;
+    F func;
+};
+
+template<typename... Cs, typename F>
+System<Access<Cs...>, F> makeSystem(F func) {
+    return {std::move(func)};
+}
+
+// Entity-component-system with archetype storage: entities with the same set of
+// components share one Archetype and every component is its own contiguous column,
+// so a system walks plain arrays instead of chasing one pointer per character.
+template<typename... Components>
+class World {
+    static_assert(sizeof...(Components) <= 32, "component mask is 32 bits");
+public:
+    using Mask = uint32_t;
+
+    template<typename... Cs>
+    Entity create(Cs... values) {
+        Archetype& a = archetypeFor((bit<Cs>() | ...));
+        uint32_t idx;
+        if (!freeIds.empty()) {
+            idx = freeIds.back();
+            freeIds.pop_back();
+        } else {
+            idx = static_cast<uint32_t>(locations.size());
+            locations.emplace_back();
+        }
+        Location& loc = locations[idx];
+        loc.archetype = static_cast<uint32_t>(&a - archetypes.data());
+        loc.row = static_cast<uint32_t>(a.entities.size());
+        loc.alive = true;
+        Entity e{idx, loc.generation};
+        a.entities.push_back(e);
+        (std::get<vector<Cs>>(a.columns).push_back(std::move(values)), ...);
+        return e;
+    }
+
+    bool contains(Entity e) const {
+        return e.index < locations.size() && locations[e.index].alive && locations[e.index].generation == e.generation;
+    }
+
+    // swap-remove from the archetype so the columns stay dense; false for a stale id
+    bool destroy(Entity e) {
+        if (!contains(e)) return false;
+        Location& loc = locations[e.index];
+        Archetype& a = archetypes[loc.archetype];
+        Entity moved = a.entities.back();
+        a.entities[loc.row] = moved;
+        a.entities.pop_back();
+        (swapRemove<Components>(a, loc.row), ...);
+        locations[moved.index].row = loc.row;
+        loc.alive = false;
+        ++loc.generation; // every outstanding copy of e becomes stale
+        freeIds.push_back(e.index);
+        return true;
+    }
+
+    // nullptr for a stale id or a missing component
+    template<typename C>
+    C* get(Entity e) {
+        if (!contains(e)) return nullptr;
+        const Location& loc = locations[e.index];
+        Archetype& a = archetypes[loc.archetype];
+        if (!(a.mask & bit<C>())) return nullptr;
+        return &std::get<vector<C>>(a.columns)[loc.row];
+    }
+
+    // func(span<const Entity>, span<Cs>...) once per matching archetype
+    template<typename... Cs, typename F>
+    void each(F&& func) {
+        const Mask m = (bit<std::remove_const_t<Cs>>() | ...);
+        for (auto& a : archetypes) {
+            if ((a.mask & m) != m || a.entities.empty()) continue;
+            func(std::span<const Entity>(a.entities), column<Cs>(a)...);
+        }
+    }
+
+    // like each(), but every archetype is split into nThreads row ranges
+    template<typename... Cs, typename F>
+    void eachParallel(F&& func, int nThreads) {
+        const Mask m = (bit<std::remove_const_t<Cs>>() | ...);
+        vector<future<void>> futures;
+        for (auto& a : archetypes) {
+            if ((a.mask & m) != m || a.entities.empty()) continue;
+            const size_t n = a.entities.size();
+            for (int t = 0; t < nThreads; ++t) {
+                size_t begin = t * n / nThreads, end = (t + 1) * n / nThreads;
+                if (begin == end) continue;
+                futures.push_back(async(launch::async, [&func, &a, begin, end] {
+                    func(std::span<const Entity>(a.entities).subspan(begin, end - begin),
+                         column<Cs>(a).subspan(begin, end - begin)...);
+                }));
+            }
+        }
+        for (auto& f : futures) f.get();
+    }
+
+    template<typename Acc, typename F>
+    void run(System<Acc, F>& system) { runImpl(system, Acc{}); }
+
+    // Systems run concurrently; rejected at compile time if one writes a component another touches.
+    template<typename... Systems>
+    void runParallel(Systems&... systems) {
+        static_assert(pairwiseDisjoint<typename Systems::AccessType...>(), "systems write overlapping components");
+        vector<future<void>> futures;
+        (futures.push_back(async(launch::async, [this, &systems] { run(systems); })), ...);
+        for (auto& f : futures) f.get();
+    }
+
+    size_t size() const { return locations.size() - freeIds.size(); }
+private:
+    struct Archetype {
+        Mask mask;
+        tuple<vector<Components>...> columns;
+        vector<Entity> entities;
+    };
+    struct Location {
+        uint32_t archetype = 0;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+
+    template<typename C>
+    static constexpr Mask bit() {
+        static_assert((std::is_same_v<C, Components> || ...), "component is not registered in this World");
+        constexpr bool matches[] = {std::is_same_v<C, Components>...};
+        for (size_t i = 0; i < sizeof...(Components); ++i) {
+            if (matches[i]) return Mask(1) << i;
+        }
+        return 0;
+    }
+
+    template<typename C>
+    static auto column(Archetype& a) {
+        return std::span<C>(std::get<vector<std::remove_const_t<C>>>(a.columns));
+    }
+
+    template<typename C>
+    void swapRemove(Archetype& a, uint32_t row) {
+        if (!(a.mask & bit<C>())) return;
+        auto& col = std::get<vector<C>>(a.columns);
+        col[row] = std::move(col.back());
+        col.pop_back();
+    }
+
+    Archetype& archetypeFor(Mask m) {
+        for (auto& a : archetypes) {
+            if (a.mask == m) return a;
+        }
+        archetypes.push_back(Archetype{m, {}, {}});
+        return archetypes.back();
+    }
+
+    template<typename... Cs, typename F>
+    void runImpl(System<Access<Cs...>, F>& system, Access<Cs...>) {
+        each<Cs...>(system.func);
+    }
+
+    template<typename... Cs>
+    static constexpr Mask writeMask(Access<Cs...>) {
+        return ((std::is_const_v<Cs> ? Mask(0) : bit<std::remove_const_t<Cs>>()) | ... | Mask(0));
+    }
+    template<typename... Cs>
+    static constexpr Mask touchMask(Access<Cs...>) {
+        return (bit<std::remove_const_t<Cs>>() | ... | Mask(0));
+    }
+    template<typename... Accs>
+    static constexpr bool pairwiseDisjoint() {
+        constexpr Mask writes[] = {writeMask(Accs{})...};
+        constexpr Mask touches[] = {touchMask(Accs{})...};
+        for (size_t i = 0; i < sizeof...(Accs); ++i) {
+            for (size_t j = 0; j < sizeof...(Accs); ++j) {
+                if (i != j && (writes[i] & touches[j])) return false;
+            }
+        }
+        return true;
+    }
+
+    vector<Archetype> archetypes;
+    vector<Location> locations;
+    vector<uint32_t> freeIds;
+};
+
+// RPG components
+struct Position { float x, y; };
+struct Velocity { float dx, dy; };
+struct Health   { int hp; };
+struct Weapon   { int damage; };
+
+using RpgWorld = World<Position, Velocity, Health, Weapon>;
+
+// lowest HP among alive characters, two flat passes so the min scan vectorizes
+std::pair<Entity, int> lowestHp(RpgWorld& world) {
+    int best = INT_MAX;
+    Entity bestId; // invalid index when nobody is alive
+    world.each<const Health>([&](std::span<const Entity> ids, std::span<const Health> health) {
+        int m = INT_MAX;
+        for (const auto& h : health) {
+            int v = h.hp > 0 ? h.hp : INT_MAX;
+            m = v < m ? v : m;
+        }
+        if (m < best) {
+            best = m;
+            for (size_t i = 0; i < health.size(); ++i) {
+                if (health[i].hp == m) { bestId = ids[i]; break; }
+            }
+        }
+    });
+    return {bestId, best};
+}
+
+// pointer-per-object version as the project two spec describes it
+struct ItemObj { int damage; };
+struct CharacterObj {
+    string name;
+    std::tuple<float, float> position;
+    std::tuple<float, float> velocity;
+    int hp;
+    shared_ptr<ItemObj> weapon;
+};
+
+int main() {
+    const int nEntities = 200'000;
+    const int nTicks = 60;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> speed(-1.0f, 1.0f);
+
+    cout << "\n\nProblem 1: Object-per-entity characters with smart pointers" << endl;
+    vector<unique_ptr<CharacterObj>> objects;
+    for (int i = 0; i < nEntities; ++i) {
+        objects.push_back(make_unique<CharacterObj>(CharacterObj{
+            "hero" + to_string(i), {0.0f, 0.0f}, {speed(rng), speed(rng)},
+            static_cast<int>(rng() % 1000) + 1, make_shared<ItemObj>(ItemObj{static_cast<int>(rng() % 50)})}));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    const CharacterObj* weakest = nullptr;
+    for (int t = 0; t < nTicks; ++t) {
+        for (auto& c : objects) {
+            std::get<0>(c->position) += std::get<0>(c->velocity);
+            std::get<1>(c->position) += std::get<1>(c->velocity);
+            if (c->hp > 0) c->hp -= c->weapon->damage % 3;
+        }
+        auto alive = objects | views::filter([](const auto& c) { return c->hp > 0; });
+        weakest = ranges::min_element(alive, {}, [](const auto& c) { return c->hp; })->get();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << "Lowest HP " << weakest->hp << ", " << ms / double(nTicks) << " ms per tick" << endl;
+
+    cout << "\n\nProblem 2: Same workload in an archetype ECS" << endl;
+    RpgWorld world;
+    rng.seed(3);
+    for (int i = 0; i < nEntities; ++i) {
+        Velocity v{speed(rng), speed(rng)};
+        Health h{static_cast<int>(rng() % 1000) + 1};
+        Weapon w{static_cast<int>(rng() % 50)};
+        world.create(Position{0.0f, 0.0f}, v, h, w);
+    }
+    auto movement = makeSystem<Position, const Velocity>(
+        [](std::span<const Entity>, std::span<Position> pos, std::span<const Velocity> vel) {
+            for (size_t i = 0; i < pos.size(); ++i) {
+                pos[i].x += vel[i].dx;
+                pos[i].y += vel[i].dy;
+            }
+        });
+    auto combat = makeSystem<Health, const Weapon>(
+        [](std::span<const Entity>, std::span<Health> health, std::span<const Weapon> weapon) {
+            for (size_t i = 0; i < health.size(); ++i) {
+                int dmg = health[i].hp > 0 ? weapon[i].damage % 3 : 0;
+                health[i].hp -= dmg;
+            }
+        });
+    std::pair<Entity, int> lowest;
+    start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < nTicks; ++t) {
+        world.run(movement);
+        world.run(combat);
+        lowest = lowestHp(world);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << "Lowest HP " << lowest.second << " (entity " << lowest.first.index << "), " << ms / double(nTicks) << " ms per tick" << endl;
+
+    cout << "\n\nProblem 3: Disjoint systems in parallel" << endl;
+    start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < nTicks; ++t) {
+        world.runParallel(movement, combat); // Position/Velocity and Health/Weapon do not overlap
+        lowest = lowestHp(world);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << "Lowest HP " << lowest.second << ", " << ms / double(nTicks) << " ms per tick" << endl;
+    // auto heal = makeSystem<Health>(...); world.runParallel(combat, heal); // compile error: both write Health
+
+    cout << "\n\nProblem 4: Split one system across threads" << endl;
+    int nThreads = std::max(1u, std::thread::hardware_concurrency());
+    start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < nTicks; ++t) {
+        world.eachParallel<Position, const Velocity>(
+            [](std::span<const Entity>, std::span<Position> pos, std::span<const Velocity> vel) {
+                for (size_t i = 0; i < pos.size(); ++i) {
+                    pos[i].x += vel[i].dx;
+                    pos[i].y += vel[i].dy;
+                }
+            }, nThreads);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    cout << nThreads << " threads, " << ms / double(nTicks) << " ms per tick for movement" << endl;
+
+    world.destroy(lowest.first);
+    cout << "Entities after removing the weakest: " << world.size() << endl;
+    Entity newcomer = world.create(Position{0.0f, 0.0f}, Health{30}); // reuses the freed index
+    cout << "Newcomer took index " << newcomer.index << ", old id still resolves: " << boolalpha
+         << (world.get<Health>(lowest.first) != nullptr) << ", second destroy succeeds: " << world.destroy(lowest.first) << endl;
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <map>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <random>
+#include <chrono>
+#include <cstdint>
+using namespace std;
+
+// FNV-1a with a final avalanche step, otherwise the low bits (all that survive
+// "% n" for small tables) barely depend on the seed. constexpr so command names
+// can be hashed at compile time.
+constexpr uint64_t fnv1a(std::string_view s, uint64_t seed = 0) {
+    uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+// name plus its base hash, computed once instead of on every lookup
+struct CommandKey {
+    std::string_view name;
+    uint64_t hash;
+    constexpr CommandKey(std::string_view name) : name(name), hash(fnv1a(name)) {}
+    constexpr CommandKey(const char* name) : CommandKey(std::string_view(name)) {}
+};
+
+// Commands are registered into a staging list, freeze() builds a minimal perfect
+// hash (hash and displace) over the names, after that every lookup is one hash,
+// one displacement load and one string compare against the only candidate slot.
+class CommandDispatcher {
+public:
+    using Handler = std::function<void(std::string_view args)>;
+
+    void add(std::string name, Handler handler) {
+        if (frozen) throw std::logic_error("dispatcher is frozen");
+        staging.push_back({std::move(name), std::move(handler)});
+    }
+
+    void freeze() {
+        if (frozen) throw std::logic_error("dispatcher is frozen");
+        const size_t n = staging.size();
+        // equal names always collide, so reject them before searching for seeds
+        vector<std::string_view> sorted;
+        for (const auto& s : staging) sorted.push_back(s.name);
+        std::sort(sorted.begin(), sorted.end());
+        auto dup = std::adjacent_find(sorted.begin(), sorted.end());
+        if (dup != sorted.end()) throw std::invalid_argument("duplicate command " + std::string(*dup));
+
+        nBuckets = std::max<size_t>(1, n / 2 + 1);
+        displacement.assign(nBuckets, 0);
+        names.assign(n, {});
+        handlers.assign(n, {});
+
+        vector<vector<size_t>> buckets(nBuckets);
+        for (size_t i = 0; i < n; ++i) {
+            buckets[fnv1a(staging[i].name) % nBuckets].push_back(i);
+        }
+        // place the fullest buckets first, each gets the first seed with no collision
+        vector<size_t> order(nBuckets);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+        vector<bool> used(n, false);
+        for (size_t b : order) {
+            if (buckets[b].empty()) break;
+            for (uint32_t seed = 1;; ++seed) {
+                vector<size_t> slots;
+                bool ok = true;
+                for (size_t i : buckets[b]) {
+                    size_t slot = fnv1a(staging[i].name, seed) % n;
+                    if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) { ok = false; break; }
+                    slots.push_back(slot);
+                }
+                if (!ok) continue;
+                for (size_t k = 0; k < slots.size(); ++k) {
+                    used[slots[k]] = true;
+                    names[slots[k]] = std::move(staging[buckets[b][k]].name);
+                    handlers[slots[k]] = std::move(staging[buckets[b][k]].handler);
+                }
+                displacement[b] = seed;
+                break;
+            }
+        }
+        staging.clear();
+        frozen = true;
+    }
+
+    // returns false for an unknown command, nothing is allocated
+    bool dispatch(CommandKey key, std::string_view args = {}) const {
+        if (names.empty()) return false;
+        uint32_t seed = displacement[key.hash % nBuckets];
+        size_t slot = fnv1a(key.name, seed) % names.size();
+        if (seed == 0 || names[slot] != key.name) return false;
+        handlers[slot](args);
+        return true;
+    }
+
+    // one command per line: "<name> <args...>", returns the number of unknown commands
+    size_t dispatchBatch(std::string_view script) const {
+        size_t unknown = 0;
+        while (!script.empty()) {
+            size_t eol = script.find('\n');
+            std::string_view line = script.substr(0, eol);
+            script.remove_prefix(eol == std::string_view::npos ? script.size() : eol + 1);
+            if (line.empty()) continue;
+            size_t space = line.find(' ');
+            std::string_view name = line.substr(0, space);
+            std::string_view args = space == std::string_view::npos ? std::string_view{} : line.substr(space + 1);
+            if (!dispatch(name, args)) ++unknown;
+        }
+        return unknown;
+    }
+    size_t size() const { return names.size(); }
+private:
+    struct Staged {
+        std::string name;
+        Handler handler;
+    };
+    vector<Staged> staging;
+    vector<uint32_t> displacement; // 0 marks an empty bucket
+    vector<std::string> names;
+    vector<Handler> handlers;
+    size_t nBuckets = 1;
+    bool frozen = false;
+};
+
+int main() {
+    cout << "\n\nProblem 1: RPG command system on a perfect hash" << endl;
+    int hp = 100;
+    int gold = 0;
+    CommandDispatcher commands;
+    commands.add("attack", [&](std::string_view) { cout << "You attack the goblin!" << endl; });
+    commands.add("heal", [&](std::string_view) { hp += 10; cout << "HP: " << hp << endl; });
+    commands.add("loot", [&](std::string_view args) { cout << "You loot " << args << endl; });
+    commands.add("status", [&](std::string_view) { cout << "HP " << hp << ", gold " << gold << endl; });
+    commands.freeze();
+
+    constexpr CommandKey attack("attack"); // hashed at compile time
+    commands.dispatch(attack);
+    size_t skipped = commands.dispatchBatch("heal\nloot rusty sword\nstatus\ndance\n");
+    cout << "Unknown commands in script: " << skipped << endl;
+    if (!commands.dispatch("fly")) cout << "Unknown command: fly" << endl;
+
+    cout << "\n\nProblem 2: Replay 10 million scripted commands" << endl;
+    const vector<string> verbs = {"attack", "defend", "heal", "loot", "move", "status", "cast", "flee",
+                                  "equip", "unequip", "inventory", "talk", "trade", "rest", "save", "quit"};
+    const int nCommands = 10'000'000;
+    long long counter = 0;
+
+    map<string, function<void()>> mapCommands;
+    CommandDispatcher fastCommands;
+    for (size_t i = 0; i < verbs.size(); ++i) {
+        mapCommands[verbs[i]] = [&counter, i] { counter += i; };
+        fastCommands.add(verbs[i], [&counter, i](std::string_view) { counter += i; });
+    }
+    fastCommands.freeze();
+
+    std::mt19937 rng(9);
+    string script;
+    script.reserve(nCommands * 8);
+    for (int i = 0; i < nCommands; ++i) {
+        script += verbs[rng() % verbs.size()];
+        script += '\n';
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t pos = 0;
+    while (pos < script.size()) {
+        size_t eol = script.find('\n', pos);
+        string name = script.substr(pos, eol - pos); // map<string, ...> needs a string key
+        pos = eol + 1;
+        auto it = mapCommands.find(name);
+        if (it != mapCommands.end()) it->second();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    cout << "std::map<string, function>: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms (checksum " << counter << ")" << endl;
+
+    counter = 0;
+    start = std::chrono::high_resolution_clock::now();
+    size_t unknown = fastCommands.dispatchBatch(script);
+    end = std::chrono::high_resolution_clock::now();
+    cout << "CommandDispatcher batch:    " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+         << " ms (checksum " << counter << ", unknown " << unknown << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <iomanip>
+using namespace std;
+
+// count, sum, min, max and variance (Welford). merge() is Chan's parallel update,
+// it is associative so partial aggregates can be combined in any grouping.
+struct RunningStats {
+    size_t count = 0;
+    double sum = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0; // sum of squared distances from the mean
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double x) {
+        ++count;
+        sum += x;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+    void merge(const RunningStats& o) {
+        if (o.count == 0) return;
+        if (count == 0) { *this = o; return; }
+        size_t n = count + o.count;
+        double delta = o.mean - mean;
+        mean += delta * o.count / n;
+        m2 += o.m2 + delta * delta * (static_cast<double>(count) * o.count / n);
+        count = n;
+        sum += o.sum;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+    }
+    static RunningStats of(std::span<const double> values) {
+        RunningStats s;
+        for (double x : values) s.add(x);
+        return s;
+    }
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+};
+
+// FIFO of aggregates with O(1) amortized push/pop and O(1) query: two stacks where
+// every entry also stores the aggregate of itself and everything below it.
+// Popping the front stack when it is empty flips the back stack over once.
+template<typename Agg>
+class SlidingAggregate {
+public:
+    void push(const Agg& a) {
+        Agg below = back.empty() ? Agg{} : back.back().total;
+        below.merge(a);
+        back.push_back({a, below});
+    }
+    void pop() {
+        if (front.empty()) {
+            while (!back.empty()) {
+                Agg total = back.back().value;
+                if (!front.empty()) total.merge(front.back().total);
+                front.push_back({back.back().value, total});
+                back.pop_back();
+            }
+        }
+        front.pop_back();
+    }
+    Agg query() const {
+        Agg result = front.empty() ? Agg{} : front.back().total;
+        if (!back.empty()) result.merge(back.back().total);
+        return result;
+    }
+    size_t size() const { return front.size() + back.size(); }
+private:
+    struct Entry {
+        Agg value;
+        Agg total;
+    };
+    vector<Entry> front;
+    vector<Entry> back;
+};
+
+// Full history plus two windows: the last N values, and the batches appended in the
+// last `span` of time. Producers aggregate a batch before taking the lock, so the
+// critical section is O(1) for history and the time window and O(batch) only for
+// the count window, which needs element granularity. Readers copy O(1) aggregates
+// under the same lock, so every snapshot is consistent across all three views.
+class StreamStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Snapshot {
+        RunningStats history;
+        RunningStats lastN;
+        RunningStats lastSpan;
+    };
+
+    StreamStats(size_t windowCount, Clock::duration windowSpan) : windowCount(windowCount), windowSpan(windowSpan) {}
+
+    // stamped after taking the lock, so batchTimes stays in time order across producers
+    void append(std::span<const double> batch) {
+        RunningStats batchStats = RunningStats::of(batch); // outside the lock
+        std::lock_guard<std::mutex> lock(mtx);
+        insert(batch, batchStats, Clock::now());
+    }
+    // explicit timestamps (replays, tests) are clamped to the newest batch for the same reason
+    void append(std::span<const double> batch, Clock::time_point now) {
+        RunningStats batchStats = RunningStats::of(batch);
+        std::lock_guard<std::mutex> lock(mtx);
+        insert(batch, batchStats, batchTimes.empty() ? now : std::max(now, batchTimes.back()));
+    }
+    void append(double x) { append(std::span<const double>(&x, 1)); }
+    void append(double x, Clock::time_point now) { append(std::span<const double>(&x, 1), now); }
+
+    Snapshot snapshot(Clock::time_point now = Clock::now()) {
+        std::lock_guard<std::mutex> lock(mtx);
+        expire(now);
+        return {history, countWindow.query(), timeWindow.query()};
+    }
+private:
+    void insert(std::span<const double> batch, const RunningStats& batchStats, Clock::time_point now) {
+        history.merge(batchStats);
+        timeWindow.push(batchStats);
+        batchTimes.push_back(now);
+        for (double x : batch) {
+            RunningStats one;
+            one.add(x);
+            countWindow.push(one);
+            if (countWindow.size() > windowCount) countWindow.pop();
+        }
+        expire(now);
+    }
+    void expire(Clock::time_point now) {
+        while (!batchTimes.empty() && batchTimes[expired] < now - windowSpan) {
+            timeWindow.pop();
+            ++expired;
+            if (expired == batchTimes.size()) { batchTimes.clear(); expired = 0; }
+        }
+        if (expired > 4096 && expired * 2 > batchTimes.size()) { // reclaim the consumed prefix
+            batchTimes.erase(batchTimes.begin(), batchTimes.begin() + expired);
+            expired = 0;
+        }
+    }
+
+    std::mutex mtx;
+    size_t windowCount;
+    Clock::duration windowSpan;
+    RunningStats history;
+    SlidingAggregate<RunningStats> countWindow;
+    SlidingAggregate<RunningStats> timeWindow;
+    vector<Clock::time_point> batchTimes; // one per batch in timeWindow, from index `expired`
+    size_t expired = 0;
+};
+
+void printStats(const char* label, const RunningStats& s) {
+    cout << setw(12) << label << setw(12) << s.count << setw(14) << fixed << setprecision(2) << s.mean
+         << setw(14) << std::sqrt(s.variance()) << setw(10) << s.min << setw(10) << s.max << endl;
+}
+
+int main() {
+    cout << "\n\nProblem 1: Sliding window over a stream of values" << endl;
+    StreamStats small(3, std::chrono::seconds(60));
+    for (double x : {4.0, 8.0, 15.0, 16.0, 23.0, 42.0}) {
+        small.append(x);
+        auto snap = small.snapshot();
+        cout << "after " << x << ": history mean " << snap.history.mean << ", last-3 mean " << snap.lastN.mean
+             << ", last-3 max " << snap.lastN.max << endl;
+    }
+
+    cout << "\n\nProblem 2: 4 producers appending while a reader takes snapshots" << endl;
+    const int nProducers = 4;
+    const int nBatches = 2'000;
+    const int batchSize = 1'000;
+    StreamStats stream(100'000, std::chrono::milliseconds(50));
+    std::atomic<int> running{nProducers};
+    vector<std::thread> producers;
+    for (int p = 0; p < nProducers; ++p) {
+        producers.emplace_back([&stream, &running, p] {
+            std::mt19937 rng(p);
+            std::normal_distribution<double> dist(100.0 + p, 15.0);
+            vector<double> batch(batchSize);
+            for (int b = 0; b < nBatches; ++b) {
+                for (auto& x : batch) x = dist(rng);
+                stream.append(batch);
+            }
+            --running;
+        });
+    }
+    int nSnapshots = 0;
+    while (running > 0) {
+        auto snap = stream.snapshot();
+        // consistent snapshot: the window can never hold more than the history
+        if (snap.lastN.count > snap.history.count) cout << "inconsistent snapshot!" << endl;
+        ++nSnapshots;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (auto& t : producers) t.join();
+    cout << "Reader took " << nSnapshots << " snapshots while producers were running" << endl;
+
+    auto snap = stream.snapshot();
+    cout << setw(12) << "View" << setw(12) << "Count" << setw(14) << "Mean" << setw(14) << "Stddev"
+         << setw(10) << "Min" << setw(10) << "Max" << endl;
+    printStats("history", snap.history);
+    printStats("last 100k", snap.lastN);
+    printStats("last 50ms", snap.lastSpan);
+
+    cout << "\n\nProblem 3: Read cost, O(1) snapshot vs recomputing from scratch" << endl;
+    vector<double> all(static_cast<size_t>(nProducers) * nBatches * batchSize);
+    std::mt19937 rng(1);
+    std::normal_distribution<double> dist(100.0, 15.0);
+    for (auto& x : all) x = dist(rng);
+    auto start = std::chrono::high_resolution_clock::now();
+    RunningStats scratch = RunningStats::of(all);
+    auto end = std::chrono::high_resolution_clock::now();
+    cout << "recompute over " << scratch.count << " values (mean " << scratch.mean << "): "
+         << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us" << endl;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 1000; ++i) snap = stream.snapshot();
+    end = std::chrono::high_resolution_clock::now();
+    cout << "snapshot: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000 << " ns" << endl;
+    return 0;
+}